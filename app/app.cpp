@@ -1,4 +1,7 @@
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -6,12 +9,19 @@
 #include <vector>
 
 #include "../include/Nonogram.h"
+#include "../include/NonogramBatch.h"
 #include "../include/NonogramPrinter.h"
 #include "../include/NonogramSource.h"
 #include "../include/solvers/DPSolver.h"
 #include "../include/solvers/NonogramSolver.h"
+#include "../include/solvers/SolverOptions.h"
 #include "../include/solvers/TrivialConstraintsSolver.h"
 
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
 // #include "src/Nonogram.cpp"
 // #include "src/NonogramPrinter.cpp"
 // #include "src/NonogramSource.cpp"
@@ -22,7 +32,202 @@
 // #include "src/solvers/NonogramSolver.cpp"
 // #include "src/solvers/TrivialConstraintsSolver.cpp"
 
-int main() {
+// The look of styled grids, both for the single puzzle and --print styled in batch mode
+PrintStyle app_print_style() {
+    PrintStyle style;
+    style.filled = "+";
+    style.cellSpace = " ";
+    style.empty = ".";
+    style.unknown = "?";
+    return style;
+}
+
+// --print styled|bits|rle|text, the names print_format_name gives
+bool parse_print_format(const std::string &name, PrintFormat &out) {
+    for (const PrintFormat format :
+         {PrintFormat::Styled, PrintFormat::Bits, PrintFormat::RunLength, PrintFormat::Text}) {
+        if (name == print_format_name(format)) {
+            out = format;
+            return true;
+        }
+    }
+    std::cerr << "Unknown print format: " << name << " (styled, bits, rle or text)\n";
+    return false;
+}
+
+// PBM bytes mustn't have \n turned into \r\n on the way out
+void binary_stdout() {
+#ifdef _WIN32
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+}
+
+// app --batch <file|dir>... [--threads N] [--format csv|jsonl] [--timeout MS] [--mode solve|verify|check|unique]
+// Solves every puzzle given and writes one record per puzzle to stdout, in argument order.
+// --mode verify checks the grid drawn in each file against the clues instead, check solves and compares with it,
+// unique counts solutions up to --limit N (2 by default) and names a cell the first two disagree on.
+// app --stream [FILE|-] [--threads N] [--format csv|jsonl] [--timeout MS] [--mode ...] [--queue N]
+// Same records for a stream of puzzles (NonogramStreamSource) read from FILE, or stdin without one or with -.
+// Both take --cache DIR [--cache-size MB]: solutions are kept in DIR (SolutionCache) and puzzles found there aren't solved,
+// and the solver settings of SolverOptions (--schedule ...).
+// --print styled|bits|rle|text [--out FILE] prints each solution found after its record, or to FILE.
+int run_batch(int argc, char **argv) {
+    BatchOptions options;
+    options.print_style = app_print_style();
+    std::vector<std::string> paths;
+    bool stream = false;
+    bool print_grids = false;
+    std::string out_path;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--batch") {
+            continue;
+        } else if (arg == "--stream") {
+            stream = true;
+        } else if (arg == "--limit" && i + 1 < argc) {
+            options.solution_limit = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--print" && i + 1 < argc) {
+            if (!parse_print_format(argv[++i], options.print_format))
+                return 2;
+            print_grids = true;
+        } else if (arg == "--out" && i + 1 < argc) {
+            out_path = argv[++i];
+            print_grids = true;
+        } else if (arg == "--queue" && i + 1 < argc) {
+            options.queue_depth = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        } else if (is_solver_option(arg) && i + 1 < argc) {
+            std::string error;
+            if (!parse_solver_option(arg, argv[i + 1], options.solver, error)) {
+                std::cerr << error << "\n";
+                return 2;
+            }
+            ++i;
+        } else if (arg == "--cache" && i + 1 < argc) {
+            options.cache_dir = argv[++i];
+        } else if (arg == "--cache-size" && i + 1 < argc) {
+            options.cache_max_bytes = static_cast<std::uint64_t>(std::max(1, std::atoi(argv[++i]))) << 20;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (arg == "--timeout" && i + 1 < argc) {
+            options.timeout_ms = std::atof(argv[++i]);
+        } else if (arg == "--mode" && i + 1 < argc) {
+            const std::string mode = argv[++i];
+            if (mode == "solve") {
+                options.mode = BatchMode::Solve;
+            } else if (mode == "verify") {
+                options.mode = BatchMode::Verify;
+            } else if (mode == "check") {
+                options.mode = BatchMode::SolveAndCheck;
+            } else if (mode == "unique") {
+                options.mode = BatchMode::Unique;
+            } else {
+                std::cerr << "Unknown mode: " << mode << " (solve, verify, check or unique)\n";
+                return 2;
+            }
+        } else if (arg == "--format" && i + 1 < argc) {
+            const std::string format = argv[++i];
+            if (format == "csv") {
+                options.format = BatchFormat::Csv;
+            } else if (format == "jsonl") {
+                options.format = BatchFormat::JsonLines;
+            } else {
+                std::cerr << "Unknown format: " << format << " (csv or jsonl)\n";
+                return 2;
+            }
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Unknown option: " << arg << "\n"
+                      << "usage: app --batch <file|dir>... [--threads N] [--format csv|jsonl] [--timeout MS]\n"
+                      << "                 [--mode solve|verify|check|unique] [--limit N] [--cache DIR]\n"
+                      << "                 [--cache-size MB]\n"
+                      << "       app --stream [FILE|-] [--threads N] [--format csv|jsonl] [--timeout MS]\n"
+                      << "                 [--mode solve|verify|check|unique] [--limit N] [--queue N]\n"
+                      << "                 [--cache DIR] [--cache-size MB]\n"
+                      << "       app [--print styled|bits|rle|text] [--out FILE]   (the puzzle in puzzleName.txt)\n"
+                      << "   both also take [--print styled|bits|rle|text] [--out FILE] for the solutions, and\n"
+                      << "                  [--schedule fifo|most-changed|least-slack|cheapest] [--search-threads N]\n"
+                      << "                  [--probe off|root|every] [--branch first|constrained|probe]\n"
+                      << "                  [--value filled|empty|feasibility] [--branch-mode cells|lines]\n";
+            return 2;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    NonogramBatch batch(options);
+    if (batch.cache() && !batch.cache()->ok()) {
+        std::cerr << "Failed to create cache directory: " << options.cache_dir << "\n";
+        return 2;
+    }
+    std::ofstream grid_file;
+    std::ostream *grids = nullptr;
+    if (print_grids && !out_path.empty()) {
+        grid_file.open(out_path, std::ios::binary);
+        if (!grid_file) {
+            std::cerr << "Failed to open file: " << out_path << "\n";
+            return 2;
+        }
+        grids = &grid_file;
+    } else if (print_grids) {
+        if (options.print_format == PrintFormat::Bits)
+            binary_stdout();
+        grids = &std::cout;
+    }
+    if (stream) {
+        if (paths.size() > 1) {
+            std::cerr << "--stream reads one file or stdin\n";
+            return 2;
+        }
+        if (paths.empty() || paths[0] == "-") {
+#ifdef _WIN32
+            // frames count bytes, \r\n mustn't turn into \n on the way in
+            _setmode(_fileno(stdin), _O_BINARY);
+#endif
+            std::ios::sync_with_stdio(false);
+            batch.run_stream(std::cin, "stdin", std::cout, grids);
+            return 0;
+        }
+        std::ifstream in(paths[0], std::ios::binary);
+        if (!in) {
+            std::cerr << "Failed to open file: " << paths[0] << "\n";
+            return 2;
+        }
+        batch.run_stream(in, paths[0], std::cout, grids);
+        return 0;
+    }
+
+    for (const auto &path : paths) {
+        std::string error;
+        if (!batch.add(path, error)) {
+            std::cerr << error << "\n";
+            return 2;
+        }
+    }
+    if (batch.size() == 0) {
+        std::cerr << "No puzzles given\n";
+        return 2;
+    }
+
+    batch.run(std::cout, grids);
+    return 0;
+}
+
+// app [--print styled|bits|rle|text] [--out FILE] solves the puzzle puzzleName.txt names and prints the grid
+// in that format (NonogramPrinter) to stdout, or to FILE. Any other argument means batch mode.
+int main(int argc, char **argv) {
+    PrintFormat print_format = PrintFormat::Styled;
+    std::string out_path;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--print" && i + 1 < argc) {
+            if (!parse_print_format(argv[++i], print_format))
+                return 2;
+        } else if (arg == "--out" && i + 1 < argc) {
+            out_path = argv[++i];
+        } else {
+            return run_batch(argc, argv);
+        }
+    }
+
     std::vector<int> OH_YEAH_VECTOR;
     std::string puzzle_name = "0003.txt";
 
@@ -38,13 +243,8 @@ int main() {
     Nonogram puzzle;
     std::string error_message;
 
-    PrintStyle style;
-    style.filled = "+";
-    style.cellSpace = " ";
-    style.empty = ".";
-    style.unknown = "?";
-
-    NonogramPrinter printer(style);
+    NonogramPrinter printer(app_print_style());
+    printer.setFormat(print_format);
 
     NonogramSource source(puzzle_directory + puzzle_name);
     if (!source.read(puzzle, error_message)) {
@@ -67,13 +267,44 @@ int main() {
 
     std::cout << std::fixed << std::setprecision(3);
     std::cout << "Solve time: " << (elapsed_us / 1000.0) << " ms" << " (" << (elapsed_us / 1000000.0) << " s)\n";
+    const SolverStats &stats = strategy.stats();
+    std::cout << "Phases: trivial " << stats.trivial_ms << " ms, overlap " << stats.overlap_ms
+              << " ms, arc consistency " << stats.arc_consistency_ms << " ms, search " << stats.search_ms << " ms\n";
+    std::cout << "Line propagations: " << stats.line_propagations() << " (rows " << stats.row_propagations
+              << ", columns " << stats.col_propagations << "), queue pushes " << stats.queue_pushes << "\n";
+    std::cout << "Cells fixed: trivial " << stats.trivial_fixed_cells << ", overlap " << stats.overlap_fixed_cells
+              << ", root propagation " << stats.root_fixed_cells << ", probes " << stats.probe_fixed_cells << "\n";
+    for (const auto &entry : strategy.strategyStats())
+        std::cout << "Strategy " << entry.name << ": " << entry.runs << " runs, " << entry.fixed_cells
+                  << " cells fixed, " << entry.ms << " ms\n";
+    std::cout << "Search nodes: " << stats.nodes << ", backtracks " << stats.backtracks << ", max depth "
+              << stats.max_depth << "\n";
+#ifdef NONOGRAM_COUNT_ALLOCATIONS
+    std::cout << "Search allocations: " << strategy.searchAllocations() << "\n";
+#endif
 
     if (!error_message.empty())
         std::cerr << "SOLVE ERROR:\n"
                   << error_message << "\n";
 
     std::cout << (solved ? "" : "not ") << "solved" << "\n";
-    printer.print(puzzle);
+    std::string print_error;
+    if (out_path.empty()) {
+        // the report so far is in cout's buffer, the grid goes straight to the descriptor after it
+        std::cout.flush();
+        if (print_format == PrintFormat::Bits)
+            binary_stdout();
+        printer.print(puzzle, 1, print_error);
+    } else {
+        std::ofstream file(out_path, std::ios::binary);
+        if (!file)
+            print_error = "Failed to open file: " + out_path;
+        else if (printer.print(puzzle, file, print_error))
+            std::cout << "Wrote " << print_format_name(print_format) << " grid to " << out_path << "\n";
+    }
+    if (!print_error.empty())
+        std::cerr << "PRINT FAILED:\n"
+                  << print_error << "\n";
 
     int pause = 0;
     std::cin >> pause;
@@ -0,0 +1,401 @@
+// Benchmark over the puzzle corpus plus generated puzzles.
+//
+// bench [--puzzles DIR] [--skip NAME]... [--generated N] [--warmup N] [--reps N] [--timeout MS]
+//       [--json OUT] [--baseline FILE] [--threshold PCT] [--min-ms MS]
+//       [--schedule fifo|most-changed|least-slack|cheapest] [--search-threads N]
+//       [--probe off|root|every] [--branch first|constrained|probe] [--value filled|empty|feasibility]
+//       [--branch-mode cells|lines]
+//
+// Every workload is solved warmup + reps times, the reps are reported as median / p90 / p99
+// per phase (parse, trivial, overlap, arc consistency, search, total).
+// A workload whose solve hits --timeout is reported as timed_out and not run again.
+// --json writes the report, --baseline compares medians against an earlier report and
+// exits with 1 if any phase got more than --threshold percent slower.
+// Every pipeline strategy (NonogramSolver::strategyStats) has to run at least once on a puzzle the strategies
+// before it leave cells open. One that never gets a turn is reported as PIPELINE and bench exits with 1.
+// The solver settings (SolverOptions) head the report, next to every workload's nodes and line propagations,
+// so runs with different settings can be put side by side.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/Nonogram.h"
+#include "../include/NonogramGenerator.h"
+#include "../include/NonogramSource.h"
+#include "../include/solvers/NonogramSolver.h"
+#include "../include/solvers/SolverOptions.h"
+
+namespace {
+
+struct Options {
+    std::string puzzle_dir = "puzzles";
+    std::vector<std::string> skip;
+    int generated = 3; // seeds per generated size
+    int warmup = 2;
+    int reps = 15;
+    double timeout_ms = 10000.0; // per solve, 0 for none
+    std::string json_out;
+    std::string baseline;
+    double threshold_pct = 10.0;
+    double min_ms = 1.0; // phases faster than this in the baseline are too noisy to compare
+    SolverOptions solver;
+};
+
+const char *const kPhases[] = {"parse", "trivial", "overlap", "arc_consistency", "search", "total"};
+constexpr int kPhaseCount = 6;
+
+struct Workload {
+    std::string name;
+    std::string path;  // read from disk when set
+    Nonogram generated; // used when path is empty
+};
+
+struct Percentiles {
+    double median = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+};
+
+struct WorkloadReport {
+    std::string name;
+    std::string status; // solve_status_name of the solve, or read_error
+    std::size_t nodes = 0;
+    std::size_t line_propagations = 0;
+    std::string skipped_strategy; // a pipeline strategy that never ran although cells were left, empty if none
+    Percentiles phase[kPhaseCount];
+};
+
+// First strategy with no runs on a solve the pipeline didn't finish, nullptr if there is none.
+// A solve the pipeline finishes can stop before the last strategies, that's fine.
+const char *skipped_strategy(const NonogramSolver &solver, const Nonogram &puzzle) {
+    std::size_t fixed = 0;
+    for (const auto &entry : solver.strategyStats())
+        fixed += entry.fixed_cells;
+    if (fixed >= puzzle.rows() * puzzle.cols())
+        return nullptr;
+    for (const auto &entry : solver.strategyStats())
+        if (entry.runs == 0)
+            return entry.name;
+    return nullptr;
+}
+
+double ms_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Nearest-rank percentile of sorted samples
+double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty())
+        return 0.0;
+    const size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+bool parse_args(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--puzzles" && has_value) {
+            options.puzzle_dir = argv[++i];
+        } else if (arg == "--skip" && has_value) {
+            options.skip.push_back(argv[++i]);
+        } else if (arg == "--generated" && has_value) {
+            options.generated = std::atoi(argv[++i]);
+        } else if (arg == "--warmup" && has_value) {
+            options.warmup = std::atoi(argv[++i]);
+        } else if (arg == "--reps" && has_value) {
+            options.reps = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--timeout" && has_value) {
+            options.timeout_ms = std::atof(argv[++i]);
+        } else if (arg == "--json" && has_value) {
+            options.json_out = argv[++i];
+        } else if (arg == "--baseline" && has_value) {
+            options.baseline = argv[++i];
+        } else if (arg == "--threshold" && has_value) {
+            options.threshold_pct = std::atof(argv[++i]);
+        } else if (arg == "--min-ms" && has_value) {
+            options.min_ms = std::atof(argv[++i]);
+        } else if (is_solver_option(arg) && has_value) {
+            std::string error;
+            if (!parse_solver_option(arg, argv[++i], options.solver, error)) {
+                std::cerr << error << "\n";
+                return false;
+            }
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<Workload> collect_workloads(const Options &options) {
+    namespace fs = std::filesystem;
+    std::vector<Workload> workloads;
+
+    std::vector<std::string> files;
+    std::error_code ec;
+    for (const auto &entry : fs::directory_iterator(options.puzzle_dir, ec)) {
+        if (!entry.is_regular_file(ec) || entry.path().extension() != ".txt")
+            continue;
+        const std::string name = entry.path().filename().string();
+        if (std::find(options.skip.begin(), options.skip.end(), name) == options.skip.end())
+            files.push_back(entry.path().string());
+    }
+    if (ec)
+        std::cerr << "Failed to list " << options.puzzle_dir << "\n";
+    std::sort(files.begin(), files.end());
+    for (const auto &file : files)
+        workloads.push_back({file, file, Nonogram{}});
+
+    // Random grids at half density need real search from about 30x30 on, at 40x40 some seeds run for minutes
+    const std::pair<int, int> sizes[] = {{20, 20}, {30, 30}};
+    for (const auto &[rows, cols] : sizes) {
+        for (int seed = 1; seed <= options.generated; ++seed) {
+            GeneratorOptions gen;
+            gen.rows = rows;
+            gen.cols = cols;
+            gen.density = 0.5;
+            gen.seed = static_cast<std::uint64_t>(seed);
+            std::ostringstream name;
+            name << "generated/" << rows << "x" << cols << "-s" << seed;
+            workloads.push_back({name.str(), "", generate_random_puzzle(gen)});
+        }
+    }
+    return workloads;
+}
+
+WorkloadReport run_workload(const Workload &workload, const Options &options) {
+    WorkloadReport report;
+    report.name = workload.name;
+
+    std::vector<double> samples[kPhaseCount];
+    for (int rep = 0; rep < options.warmup + options.reps; ++rep) {
+        Nonogram puzzle;
+        std::string error;
+        const auto t0 = std::chrono::steady_clock::now();
+        double parse_ms = 0.0;
+        if (!workload.path.empty()) {
+            if (!NonogramSource(workload.path).read(puzzle, error)) {
+                report.status = "read_error";
+                return report;
+            }
+            parse_ms = ms_since(t0);
+        } else {
+            puzzle = workload.generated;
+        }
+
+        NonogramSolver solver;
+        SolveLimits limits;
+        limits.timeout_ms = options.timeout_ms;
+        solver.setLimits(limits);
+        apply_solver_options(solver, options.solver);
+        const bool solved = solver.solve(puzzle, error);
+        const double total_ms = ms_since(t0);
+        report.nodes = solver.searchNodes();
+        report.line_propagations = solver.linePropagations();
+        if (solver.status() == SolveStatus::TimedOut) {
+            report.status = solve_status_name(SolveStatus::TimedOut);
+            return report;
+        }
+        report.status = solve_status_name(solver.status());
+        if (solved) {
+            if (const char *name = skipped_strategy(solver, puzzle))
+                report.skipped_strategy = name;
+        }
+
+        if (rep < options.warmup)
+            continue;
+        const SolverStats &times = solver.stats();
+        samples[0].push_back(parse_ms);
+        samples[1].push_back(times.trivial_ms);
+        samples[2].push_back(times.overlap_ms);
+        samples[3].push_back(times.arc_consistency_ms);
+        samples[4].push_back(times.search_ms);
+        samples[5].push_back(total_ms);
+    }
+
+    for (int p = 0; p < kPhaseCount; ++p) {
+        std::sort(samples[p].begin(), samples[p].end());
+        report.phase[p] = {percentile(samples[p], 50), percentile(samples[p], 90), percentile(samples[p], 99)};
+    }
+    return report;
+}
+
+void print_reports(const std::vector<WorkloadReport> &reports, const Options &options) {
+    std::cout << "solver: " << describe_solver_options(options.solver) << "\n";
+    std::cout << std::left << std::setw(28) << "workload" << std::setw(18) << "phase"
+              << std::right << std::setw(12) << "median_ms" << std::setw(12) << "p90_ms" << std::setw(12) << "p99_ms"
+              << "\n";
+    std::cout << std::fixed << std::setprecision(4);
+    for (const auto &report : reports) {
+        if (report.status == "read_error" || report.status == "timed_out") {
+            std::cout << std::left << std::setw(28) << report.name << report.status << ", skipped\n";
+            continue;
+        }
+        for (int p = 0; p < kPhaseCount; ++p) {
+            std::cout << std::left << std::setw(28) << (p == 0 ? report.name : "") << std::setw(18) << kPhases[p]
+                      << std::right << std::setw(12) << report.phase[p].median
+                      << std::setw(12) << report.phase[p].p90
+                      << std::setw(12) << report.phase[p].p99 << "\n";
+        }
+        std::cout << std::left << std::setw(28) << "" << report.status << ", " << report.nodes << " nodes, "
+                  << report.line_propagations << " line propagations\n";
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+// One flat object per workload and phase, so the baseline reader only has to find keys in an object
+bool write_json(const std::string &path, const std::vector<WorkloadReport> &reports, const Options &options) {
+    std::ofstream out(path);
+    if (!out)
+        return false;
+
+    out << "[\n";
+    bool first = true;
+    for (const auto &report : reports) {
+        if (report.status == "read_error" || report.status == "timed_out")
+            continue;
+        for (int p = 0; p < kPhaseCount; ++p) {
+            out << (first ? "" : ",\n") << "{\"workload\":\"" << report.name << "\",\"phase\":\"" << kPhases[p]
+                << "\",\"status\":\"" << report.status << "\",\"nodes\":" << report.nodes
+                << ",\"line_propagations\":" << report.line_propagations
+                << ",\"solver\":\"" << describe_solver_options(options.solver) << "\""
+                << ",\"median_ms\":" << report.phase[p].median << ",\"p90_ms\":" << report.phase[p].p90
+                << ",\"p99_ms\":" << report.phase[p].p99 << "}";
+            first = false;
+        }
+    }
+    out << "\n]\n";
+    return static_cast<bool>(out);
+}
+
+// Value of "key": in a flat JSON object written by write_json, strings without their quotes
+bool json_value(const std::string &object, const std::string &key, std::string &out_value) {
+    const std::string needle = "\"" + key + "\":";
+    const size_t at = object.find(needle);
+    if (at == std::string::npos)
+        return false;
+    size_t begin = at + needle.size();
+    while (begin < object.size() && object[begin] == ' ')
+        ++begin;
+    if (begin < object.size() && object[begin] == '"') {
+        const size_t end = object.find('"', begin + 1);
+        if (end == std::string::npos)
+            return false;
+        out_value = object.substr(begin + 1, end - begin - 1);
+        return true;
+    }
+    const size_t end = object.find_first_of(",}", begin);
+    out_value = object.substr(begin, end - begin);
+    return true;
+}
+
+// (workload, phase) -> median_ms
+bool read_baseline(const std::string &path, std::map<std::pair<std::string, std::string>, double> &out) {
+    std::ifstream in(path);
+    if (!in)
+        return false;
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+
+    size_t pos = 0;
+    while ((pos = text.find('{', pos)) != std::string::npos) {
+        const size_t end = text.find('}', pos);
+        if (end == std::string::npos)
+            return false;
+        const std::string object = text.substr(pos, end - pos + 1);
+        std::string workload, phase, median;
+        if (json_value(object, "workload", workload) && json_value(object, "phase", phase) &&
+            json_value(object, "median_ms", median))
+            out[{workload, phase}] = std::atof(median.c_str());
+        pos = end + 1;
+    }
+    return true;
+}
+
+// Prints every phase that got slower than the threshold, returns how many did
+int compare_to_baseline(const std::vector<WorkloadReport> &reports,
+                        const std::map<std::pair<std::string, std::string>, double> &baseline,
+                        const Options &options) {
+    int regressions = 0;
+    for (const auto &report : reports) {
+        if (report.status == "timed_out") {
+            if (baseline.count({report.name, "total"})) {
+                std::cout << "REGRESSION " << report.name << ": timed out after " << options.timeout_ms << " ms\n";
+                ++regressions;
+            }
+            continue;
+        }
+        for (int p = 0; p < kPhaseCount; ++p) {
+            const auto it = baseline.find({report.name, kPhases[p]});
+            if (it == baseline.end() || it->second < options.min_ms)
+                continue;
+            const double change_pct = (report.phase[p].median / it->second - 1.0) * 100.0;
+            if (change_pct > options.threshold_pct) {
+                std::cout << "REGRESSION " << report.name << " " << kPhases[p] << ": " << it->second << " ms -> "
+                          << report.phase[p].median << " ms (+" << change_pct << "%)\n";
+                ++regressions;
+            }
+        }
+    }
+    return regressions;
+}
+
+// Prints every workload whose pipeline skipped a strategy, returns how many did
+int check_pipeline(const std::vector<WorkloadReport> &reports) {
+    int skipped = 0;
+    for (const auto &report : reports) {
+        if (report.skipped_strategy.empty())
+            continue;
+        std::cout << "PIPELINE " << report.name << ": strategy " << report.skipped_strategy
+                  << " never ran although the strategies before it left cells open\n";
+        ++skipped;
+    }
+    return skipped;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_args(argc, argv, options))
+        return 2;
+
+    std::vector<WorkloadReport> reports;
+    for (const auto &workload : collect_workloads(options))
+        reports.push_back(run_workload(workload, options));
+    print_reports(reports, options);
+    const int skipped = check_pipeline(reports);
+
+    if (!options.json_out.empty() && !write_json(options.json_out, reports, options)) {
+        std::cerr << "Failed to write " << options.json_out << "\n";
+        return 2;
+    }
+
+    if (!options.baseline.empty()) {
+        std::map<std::pair<std::string, std::string>, double> baseline;
+        if (!read_baseline(options.baseline, baseline)) {
+            std::cerr << "Failed to read baseline " << options.baseline << "\n";
+            return 2;
+        }
+        const int regressions = compare_to_baseline(reports, baseline, options);
+        std::cout << regressions << " regression(s) over " << options.threshold_pct << "%\n";
+        if (regressions > 0)
+            return 1;
+    }
+    return skipped > 0 ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+// CellGrid.h
+#pragma once
+#include "Cell.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// rows x cols Cells packed into two bitplanes, one bit set in the filled plane for a Filled cell and one in
+// the empty plane for an Empty cell, neither for Unknown. Every row starts on its own 64-bit word.
+// A transposed copy of both planes is kept in sync by set(), so a column reads as contiguous words the
+// same way a row does. Bits past the end of a line are always 0.
+class CellGrid {
+  public:
+    using Word = std::uint64_t;
+    static constexpr size_t kWordBits = 64;
+
+    CellGrid() = default;
+    CellGrid(size_t rows, size_t cols) { assign(rows, cols); }
+
+    // rows x cols of Unknown
+    void assign(size_t rows, size_t cols);
+
+    // rows x cols from row planes laid out like row_filled()/row_empty(), row_words() words per row and bits past
+    // the end of a row 0. The transposed copy is built 64x64 bits at a time instead of cell by cell.
+    void assign_rows(size_t rows, size_t cols, std::vector<Word> filled, std::vector<Word> empty);
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+
+    Cell get(size_t r, size_t c) const {
+        const size_t w = r * row_words_ + c / kWordBits;
+        const Word bit = Word{1} << (c % kWordBits);
+        return (row_filled_[w] & bit) ? Cell::Filled : (row_empty_[w] & bit) ? Cell::Empty : Cell::Unknown;
+    }
+
+    void set(size_t r, size_t c, Cell cell) {
+        write(row_filled_, row_empty_, r * row_words_ + c / kWordBits, Word{1} << (c % kWordBits), cell);
+        write(col_filled_, col_empty_, c * col_words_ + r / kWordBits, Word{1} << (r % kWordBits), cell);
+    }
+
+    // Words of one line, row_words() per row and col_words() per column, cell i is bit i % 64 of word i / 64
+    size_t row_words() const { return row_words_; }
+    size_t col_words() const { return col_words_; }
+    const Word *row_filled(size_t r) const { return row_filled_.data() + r * row_words_; }
+    const Word *row_empty(size_t r) const { return row_empty_.data() + r * row_words_; }
+    const Word *col_filled(size_t c) const { return col_filled_.data() + c * col_words_; }
+    const Word *col_empty(size_t c) const { return col_empty_.data() + c * col_words_; }
+
+    size_t unknown_count() const;
+    size_t unknown_in_row(size_t r) const;
+    size_t unknown_in_col(size_t c) const;
+
+    // Row-major index (r * cols + c) of the first Unknown cell at or after index from, rows * cols if none
+    size_t next_unknown(size_t from) const;
+
+    void swap(CellGrid &other) noexcept;
+    bool operator==(const CellGrid &other) const;
+    bool operator!=(const CellGrid &other) const { return !(*this == other); }
+
+  private:
+    static void write(std::vector<Word> &filled, std::vector<Word> &empty, size_t w, Word bit, Cell cell) {
+        filled[w] = cell == Cell::Filled ? filled[w] | bit : filled[w] & ~bit;
+        empty[w] = cell == Cell::Empty ? empty[w] | bit : empty[w] & ~bit;
+    }
+
+    size_t rows_ = 0;
+    size_t cols_ = 0;
+    size_t row_words_ = 0;
+    size_t col_words_ = 0;
+    std::vector<Word> row_filled_;
+    std::vector<Word> row_empty_;
+    std::vector<Word> col_filled_; // transposed copies
+    std::vector<Word> col_empty_;
+};
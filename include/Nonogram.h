@@ -1,6 +1,8 @@
 // Nonogram.h
 #pragma once
 #include "Cell.h"
+#include "CellGrid.h"
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -9,7 +11,7 @@ class Nonogram {
     std::vector<std::vector<int>> row_clues{};
     std::vector<std::vector<int>> col_clues{};
 
-    std::vector<std::vector<Cell>> cells{};
+    CellGrid cells{};
 
     // nonogram size is row_clues.size() by col_clues.size(), use a function so we return the correct value every time.
     size_t rows() const;
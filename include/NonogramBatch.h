@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Nonogram.h"
+#include "NonogramPrinter.h"
+#include "SolutionCache.h"
+#include "core/PrintStyle.h"
+#include "solvers/NonogramSolver.h"
+#include "solvers/SolverOptions.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+enum class BatchFormat { Csv,
+                         JsonLines
+};
+
+// What happens to each puzzle
+// Solve: run the solver. Verify: check the grid drawn in the puzzle file against the clues, no solver.
+// SolveAndCheck: run the solver and require its solution to be the grid in the file.
+// Unique: count solutions up to solution_limit (NonogramSolver::countSolutions), 2 answers "is it unique".
+enum class BatchMode { Solve,
+                       Verify,
+                       SolveAndCheck,
+                       Unique
+};
+
+const char *batch_mode_name(BatchMode mode);
+
+struct BatchOptions {
+    int threads = 1; // puzzles solved at once, each with its own single-threaded NonogramSolver
+    BatchFormat format = BatchFormat::Csv;
+    BatchMode mode = BatchMode::Solve;
+    double timeout_ms = 0.0; // per puzzle, 0 for none
+    SolverOptions solver;    // settings of every puzzle's solver
+    int solution_limit = 2;  // Unique mode: solutions counted before the search stops
+    std::size_t queue_depth = 0; // run_stream: puzzles held between stages, 0 for twice the threads
+    // SolutionCache directory shared by every solver, empty for none. Not used in Verify mode.
+    std::string cache_dir;
+    std::uint64_t cache_max_bytes = std::uint64_t{256} << 20;
+    // how run and run_stream print solved grids when they're given a stream for them
+    PrintFormat print_format = PrintFormat::Styled;
+    PrintStyle print_style;
+};
+
+// Outcome of one puzzle
+// status: solved, unsolved (the solver proved there's no solution), timed_out, failed (see solve_status_name)
+// or read_error, in Verify mode verified or wrong,
+// in SolveAndCheck mode also mismatch (solved, but not to the file's grid),
+// in Unique mode unique, multiple, solved (one found, limit 1), unsolved or timed_out.
+// solve_ms is the time spent verifying in Verify mode. cached is set when the solution came from the cache.
+// solutions, exhausted and distinguishing_cell (row, column from 0, -1 with fewer than two solutions)
+// are only filled in Unique mode, see SolutionCount. solution is the solved puzzle, only kept for printing.
+struct BatchResult {
+    std::string path;
+    std::string status;
+    std::string error;
+    double parse_ms = 0.0;
+    double solve_ms = 0.0;
+    std::size_t nodes = 0;
+    std::size_t line_propagations = 0;
+    bool cached = false;
+    int solutions = 0;
+    bool exhausted = false;
+    std::pair<int, int> distinguishing_cell{-1, -1};
+    Nonogram solution;
+};
+
+// Solves many puzzles concurrently and writes one record per puzzle, in the order they were added.
+class NonogramBatch {
+  public:
+    explicit NonogramBatch(BatchOptions options);
+
+    // Adds a puzzle file, or every .txt and .ngb (binary) file of a directory in name order.
+    // Returns false with out_error if the path doesn't exist.
+    bool add(const std::string &path, std::string &out_error);
+
+    std::size_t size() const { return paths_.size(); }
+
+    // The cache from options.cache_dir, nullptr without one
+    const SolutionCache *cache() const { return cache_.get(); }
+
+    // Solves everything and streams the records to out. A record is written as soon as
+    // it and every record before it are done, so a slow puzzle holds back the ones after it.
+    // With grids, every solution found is printed there (NonogramPrinter) right after its record.
+    void run(std::ostream &out, std::ostream *grids = nullptr) const;
+
+    // Solves the puzzles of a stream (NonogramStreamSource) as they arrive, the paths added don't take part.
+    // One thread parses ahead, options.threads solve and the calling thread writes the records in stream order.
+    // The stages are joined by queues of options.queue_depth puzzles, so a fast producer waits rather than
+    // piling puzzles up in memory. label names the stream in the records, grids is the same as for run.
+    // Returns the number of puzzles read.
+    std::size_t run_stream(std::istream &in, const std::string &label, std::ostream &out,
+                           std::ostream *grids = nullptr) const;
+
+  private:
+    // keep_solution moves the solved puzzle into the result
+    BatchResult solve_one(const std::string &path, bool keep_solution) const;
+    // grid is the one from the puzzle file, only read in Verify and SolveAndCheck mode
+    void solve_puzzle(Nonogram &puzzle, const CellGrid &grid, BatchResult &result) const;
+    void count_solutions(NonogramSolver &solver, Nonogram &puzzle, BatchResult &result) const;
+    void print_solution(NonogramPrinter &printer, const BatchResult &result, std::ostream *grids) const;
+
+    BatchOptions options_;
+    std::vector<std::string> paths_;
+    std::unique_ptr<SolutionCache> cache_;
+};
+
+// Unique mode records get solutions, exhausted and the distinguishing cell (from 1) on top
+void write_batch_header(std::ostream &out, BatchFormat format, BatchMode mode = BatchMode::Solve);
+void write_batch_result(std::ostream &out, const BatchResult &result, BatchFormat format,
+                        BatchMode mode = BatchMode::Solve);
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Nonogram.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+// Compact binary clue format (.ngb), clues only, no cells.
+//
+//   magic "NGRM", version byte (kVersion)
+//   varint rows, cols, row clue total, column clue total
+//   varint clue count of every row, then of every column   (CSR offsets as lengths)
+//   varint clue runs of every row, then of every column    (CSR values)
+//
+// Varints are unsigned LEB128, 7 bits per byte, low bits first. Nothing may follow the last run.
+namespace BinaryFormat {
+
+constexpr char kMagic[4] = {'N', 'G', 'R', 'M'};
+constexpr std::uint8_t kVersion = 1;
+
+// True if data starts like a binary puzzle, whatever the version
+bool is_binary_format(std::string_view data);
+
+// Parses data in place. Returns false with out_error on a bad header, truncated data or a clue of 0.
+bool read_binary_format(std::string_view data, Nonogram &out_puzzle, std::string &out_error);
+
+// The encoding of puzzle's clues. Every puzzle has exactly one, so equal bytes mean equal clues.
+std::string to_binary_format(const Nonogram &puzzle);
+
+// Returns false with out_error if the stream fails
+bool write_binary_format(std::ostream &out, const Nonogram &puzzle, std::string &out_error);
+}
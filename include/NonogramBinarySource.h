@@ -0,0 +1,16 @@
+#pragma once
+
+#include "INonogramSource.h"
+#include "Nonogram.h"
+#include <string>
+
+// Loads a puzzle in BinaryFormat, the whole file in one read
+class NonogramBinarySource : public INonogramSource {
+  public:
+    explicit NonogramBinarySource(std::string path);
+
+    bool read(Nonogram &out_puzzle, std::string &out_error) override;
+
+  private:
+    std::string path_;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Cell.h"
+#include "CellGrid.h"
+#include "Nonogram.h"
+#include <cstdint>
+#include <vector>
+
+// How the source grid is drawn
+// Random: every cell on its own, Blocks: overlapping filled rectangles (closer to picture puzzles),
+// Symmetric: random left half mirrored onto the right half
+enum class GeneratorPattern { Random,
+                              Blocks,
+                              Symmetric
+};
+
+const char *generator_pattern_name(GeneratorPattern pattern);
+
+// Random puzzles for benchmarks and stress runs.
+// The same options give the same puzzle on every platform, the generator uses no library distributions.
+struct GeneratorOptions {
+    int rows = 10;
+    int cols = 10;
+    double density = 0.5; // chance of a cell being Filled, for Blocks the share of Filled cells to stop at
+    std::uint64_t seed = 1;
+    GeneratorPattern pattern = GeneratorPattern::Random;
+};
+
+// Clue of one line of a solved grid, empty for an all-Empty line
+std::vector<int> clues_from_line(const std::vector<Cell> &line);
+
+// Fills a random grid and derives the clues from it.
+// The returned puzzle has Unknown cells, out_solution (if given) receives the grid the clues came from.
+Nonogram generate_random_puzzle(const GeneratorOptions &options, CellGrid *out_solution = nullptr);
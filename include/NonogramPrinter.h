@@ -7,16 +7,39 @@
 #include <optional>
 #include <string>
 
+// How print() lays the cells out
+// Styled: PrintStyle strings per cell and row. Bits: PBM P4 image, rows bit-packed 8 cells a byte (Filled is 1).
+// RunLength: "rows cols" then a line of runs per row, each run its length (left out when 1) and + . or ?.
+// Text: the puzzles/ text format, clues with the grid on the right (TextFormat::write_text_format).
+enum class PrintFormat { Styled,
+                         Bits,
+                         RunLength,
+                         Text
+};
+
+const char *print_format_name(PrintFormat format);
+
 class NonogramPrinter {
   public:
     NonogramPrinter();
     NonogramPrinter(PrintStyle style);
     void setStyle(PrintStyle style);
+    void setFormat(PrintFormat format);
     void print(Nonogram &puzzle);
 
+    // Renders whole rows into one reused buffer and writes it out in large blocks.
+    // Returns false with out_error if writing fails.
+    bool print(const Nonogram &puzzle, std::ostream &out, std::string &out_error);
+    // Same straight to a file descriptor (1 for stdout) through core::FdStreamBuf
+    bool print(const Nonogram &puzzle, int fd, std::string &out_error);
+
   private:
     PrintStyle style;
+    PrintFormat format = PrintFormat::Styled;
+    std::string buffer;
 
-    void printRow(std::vector<Cell> &cells);
-    void printCell(Cell cell);
-};
\ No newline at end of file
+    bool flush(std::ostream &out, bool force);
+    void printRow(const CellGrid &cells, size_t row);
+    void printBitsRow(const CellGrid &cells, size_t row);
+    void printRunLengthRow(const CellGrid &cells, size_t row);
+};
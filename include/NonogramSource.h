@@ -9,7 +9,8 @@ class NonogramSource {
     explicit NonogramSource(std::string path);
 
     // Reads from the file at path_ and Returns false with out_error on failure
-    bool read(Nonogram &out_puzzle, std::string &out_error) const;
+    // out_grid (if given) gets the grid drawn next to the row clues, see TextFormat::read_text_format
+    bool read(Nonogram &out_puzzle, std::string &out_error, CellGrid *out_grid = nullptr) const;
 
   private:
     std::string path_;
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "INonogramSource.h"
+#include "Nonogram.h"
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+// Reads puzzles one after another from a stream (a file, a pipe, stdin) instead of one file per puzzle.
+// Two layouts, which can be mixed in one stream:
+//   text:   puzzles in the puzzles/ text format back to back. A puzzle ends with the last of its row lines
+//           below the separator, so `cat puzzles/*.txt` or `generate --count K` output reads as is. A file
+//           without a final newline leaves the next "R C" header at the end of its last row line, which is
+//           split off again.
+//   framed: a line "@puzzle <bytes> [name]" followed by exactly that many bytes holding one puzzle,
+//           text or BinaryFormat. A broken puzzle inside a frame can't throw the rest of the stream off.
+class NonogramStreamSource : public INonogramSource {
+  public:
+    // label names the stream in puzzle names, e.g. "stdin"
+    NonogramStreamSource(std::istream &in, std::string label);
+
+    // True once only blank lines are left
+    bool at_end();
+
+    // Reads the next puzzle. On a bad puzzle returns false with out_error and moves past it,
+    // the next read carries on with the puzzle after it.
+    bool read(Nonogram &out_puzzle, std::string &out_error) override;
+    // Also loads the grid of a text puzzle into out_grid, binary puzzles have none and fail
+    bool read(Nonogram &out_puzzle, std::string &out_error, CellGrid *out_grid);
+
+    // Name of the puzzle the last read returned: the frame name if it had one, else "<label>#<n>" counting from 1
+    const std::string &name() const { return name_; }
+
+  private:
+    bool next_line(std::string &out_line);
+    bool read_frame(const std::string &header, std::string &out_payload, std::string &out_error);
+    void read_text_chunk(const std::string &first_line, std::string &out_text);
+
+    std::istream &in_;
+    std::string label_;
+    std::string name_;
+    std::size_t count_ = 0;
+
+    // a line read while looking for the end of a puzzle that already belongs to the next one
+    std::string held_line_;
+    bool has_held_line_ = false;
+};
@@ -5,7 +5,18 @@
 
 #include <iosfwd>
 #include <string>
+#include <string_view>
 
 namespace TextFormat {
-bool read_text_format(std::istream &in, Nonogram &out_puzzle, std::string &out_error);
+// out_grid (if given) also receives the grid on the right of the row lines, + Filled and . Empty.
+// The grid is optional in the format, asking for it makes a missing or short one an error.
+bool read_text_format(std::istream &in, Nonogram &out_puzzle, std::string &out_error, CellGrid *out_grid = nullptr);
+
+// Same format and errors as the stream version, parsed in place from text (e.g. a mapped file)
+bool read_text_format(std::string_view text, Nonogram &out_puzzle, std::string &out_error, CellGrid *out_grid = nullptr);
+
+// Writes the puzzle in the layout read_text_format reads, clues right-aligned in equal width columns.
+// Row lines carry puzzle.cells on the right of the '|' (+ Filled, . otherwise), read back with out_grid.
+// Returns false with out_error if the stream fails.
+bool write_text_format(std::ostream &out, const Nonogram &puzzle, std::string &out_error);
 }
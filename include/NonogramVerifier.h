@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CellGrid.h"
+#include "Nonogram.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Checks finished grids against the clues without running a solver.
+// Lines are scanned as packed words, one count-trailing-zeros per run edge, so a grid costs
+// about R*C/64 word reads plus one step per run.
+
+// True if the Filled bits of a line (cell i is bit i % 64 of word i / 64, words * 64 >= the line length,
+// bits past the end 0) form exactly the runs of clues
+bool runs_match_clues(const CellGrid::Word *filled, size_t words, const std::vector<int> &clues);
+
+// Counts from verify_grid, a line counts once whatever is wrong with it
+struct GridCheck {
+    size_t unknown_cells = 0;
+    size_t wrong_rows = 0;
+    size_t wrong_cols = 0;
+    bool ok() const { return unknown_cells == 0 && wrong_rows == 0 && wrong_cols == 0; }
+};
+
+// Checks that grid is a solution of puzzle: the right size, no Unknown cells and every row and column
+// matching its clue. Returns false with out_error naming the first wrong line, out_check (if given) gets the counts.
+bool verify_grid(const Nonogram &puzzle, const CellGrid &grid, std::string &out_error, GridCheck *out_check = nullptr);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CellGrid.h"
+#include "Nonogram.h"
+#include <string>
+
+// The 8 ways a grid can be mirrored and turned (the symmetries of a square), applied to puzzles and grids.
+// A Symmetry flips first and transposes after: cell (r, c) goes to (r, cols-1-c) with flip_horizontal,
+// to (rows-1-r, c) with flip_vertical, then to (c, r) with transpose.
+struct Symmetry {
+    bool flip_horizontal = false;
+    bool flip_vertical = false;
+    bool transpose = false;
+};
+
+constexpr int kSymmetryCount = 8;
+
+// Symmetry number index (0 to 7), 0 is the identity
+Symmetry symmetry_from_index(int index);
+
+// Clues of the puzzle turned by symmetry, the cells aren't carried over
+Nonogram transform_clues(const Nonogram &puzzle, Symmetry symmetry);
+
+// grid turned by symmetry, and back again. Rows are mirrored a word at a time and the transpose
+// goes through CellGrid::assign_rows, so both cost about R*C/64 word operations.
+CellGrid transform_grid(const CellGrid &grid, Symmetry symmetry);
+CellGrid inverse_transform_grid(const CellGrid &grid, Symmetry symmetry);
+
+// The symmetry that turns puzzle into its canonical form, the first of the 8 by size, clue counts and then
+// clues, and the canonical form's BinaryFormat encoding in out_key. Puzzles that are turns of each other
+// get the same out_key.
+Symmetry canonical_symmetry(const Nonogram &puzzle, std::string &out_key);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Nonogram.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Solved grids kept on disk between runs, one file per puzzle in a directory, so a puzzle seen before
+// isn't solved again. A puzzle is keyed by its canonical clues (canonical_symmetry), so a mirrored or
+// turned copy of a cached puzzle hits too and gets the cached grid turned back to its orientation.
+//
+// File <16 hex digits>.ngsol, the digits an FNV-1a hash of the key: "NGSC", version byte, key length
+// (u32 little endian), the key, then the Filled plane of the canonical grid, row_words() little endian
+// u64 per row. A hash collision is caught by comparing the key, and every grid is checked against
+// the clues before it's handed out, so a damaged file is just a miss.
+//
+// Several threads and processes can share one directory: files are written under a temporary name and
+// renamed into place, so a reader sees a whole file or none. Hits touch the file's modification time and
+// once the directory grows past max_bytes the least recently used files are removed.
+class SolutionCache {
+  public:
+    // Creates directory if it isn't there
+    SolutionCache(std::string directory, std::uint64_t max_bytes);
+
+    SolutionCache(const SolutionCache &) = delete;
+    SolutionCache &operator=(const SolutionCache &) = delete;
+
+    // False if the directory couldn't be created, the cache then never hits and stores nothing
+    bool ok() const { return ok_; }
+    const std::string &directory() const { return directory_; }
+
+    // Fills puzzle.cells with the cached solution and returns true on a hit. Cells already decided
+    // in puzzle.cells have to agree with it, a cached grid that doesn't is a miss.
+    bool lookup(Nonogram &puzzle);
+
+    // Saves puzzle.cells, which has to be a solution. Returns false with out_error if it can't be written.
+    bool store(const Nonogram &puzzle, std::string &out_error);
+
+  private:
+    std::string path_for(const std::string &key) const;
+    // Removes the least recently used files until the directory is back under 90% of max_bytes_
+    void evict();
+
+    std::string directory_;
+    std::uint64_t max_bytes_;
+    bool ok_ = false;
+    std::uint64_t tag_ = 0;                 // makes this cache's temporary file names differ from other processes'
+    std::atomic<std::uint64_t> next_temp_{0};
+
+    // bytes in the directory as of the last scan plus what was stored since, other processes aren't seen
+    // until the next scan, which comes when this goes past max_bytes_ or every kScanInterval stores
+    std::mutex size_mutex_;
+    std::uint64_t estimated_bytes_ = 0;
+    std::size_t stores_since_scan_ = 0;
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstddef>
+
+namespace nonogram::core {
+
+// Number of global operator new calls made by the process so far.
+// Only counts when built with -DNONOGRAM_COUNT_ALLOCATIONS, otherwise always 0.
+std::size_t allocation_count();
+
+} // namespace nonogram::core
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <streambuf>
+#include <vector>
+
+namespace nonogram::core {
+
+// Output streambuf over a file descriptor (write() on POSIX, _write() on Windows).
+// Collects small writes in one buffer and hands writes bigger than it straight to the descriptor,
+// so a std::ostream on top of it costs one system call per buffer rather than going through stdio.
+// The descriptor isn't closed, the destructor only flushes.
+class FdStreamBuf : public std::streambuf {
+  public:
+    explicit FdStreamBuf(int fd, std::size_t buffer_size = std::size_t{1} << 16);
+    ~FdStreamBuf() override;
+
+    FdStreamBuf(const FdStreamBuf &) = delete;
+    FdStreamBuf &operator=(const FdStreamBuf &) = delete;
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char *s, std::streamsize n) override;
+    int sync() override;
+
+  private:
+    bool flush_buffer();
+    bool write_all(const char *data, std::size_t size);
+
+    int fd_;
+    std::vector<char> buffer_;
+};
+
+} // namespace nonogram::core
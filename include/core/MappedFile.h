@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace nonogram::core {
+
+// Read-only view of a whole file.
+// Regular files are memory-mapped (mmap on POSIX, MapViewOfFile on Windows) so parsing reads the page cache
+// directly. Anything that can't be mapped (empty files, pipes) is read into memory instead.
+// view() stays valid until the MappedFile is destroyed or opened again.
+class MappedFile {
+  public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // False if the file can't be opened or read
+    bool open(const std::string &path);
+
+    std::string_view view() const { return {data_, size_}; }
+    bool mapped() const { return mapped_; }
+
+  private:
+    void close();
+
+    const char *data_ = nullptr;
+    std::size_t size_ = 0;
+    bool mapped_ = false;
+    std::string fallback_;
+};
+
+} // namespace nonogram::core
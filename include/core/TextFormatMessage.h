@@ -18,11 +18,13 @@ std::string missing_pipe_column();
 std::string missing_pipe_row();
 std::string wrong_column_token_count(std::size_t got, std::size_t expected);
 std::string wrong_row_count(std::size_t got, std::size_t expected);
+std::string wrong_grid_cell_count(std::size_t got, std::size_t expected);
 
 // Token issues
 std::string empty_token();
 std::string invalid_integer_token(std::string_view token);
 std::string non_positive_clue(std::string_view token);
+std::string invalid_grid_cell(std::string_view token);
 std::string with_line(std::string_view msg, std::size_t i, std::string_view line);
 std::string token_error(TokenParseErr err, std::string_view token);
 
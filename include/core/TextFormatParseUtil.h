@@ -1,17 +1,29 @@
 #pragma once
 
 #include "enums.h"
+#include <cstddef>
 #include <string>
-#include <vector>
+#include <string_view>
 
 namespace nonogram::io::textformat {
 
-std::string trim(const std::string &s);
-std::vector<std::string> split_ws(const std::string &s);
+// std::isspace in the "C" locale, without the locale lookup per character
+inline bool is_space(char ch) {
+    return ch == ' ' || (ch >= '\t' && ch <= '\r');
+}
+
+// All of these return views into their input, nothing is copied
+std::string_view trim(std::string_view s);
+// Next whitespace separated token at or after pos (pos moves past it), empty once none are left
+std::string_view next_token(std::string_view s, std::size_t &pos);
+std::size_t count_tokens(std::string_view s);
 bool fail(std::string &out_error, std::string msg);
-bool split_pipe(const std::string &line, std::string &left, std::string &right);
-bool is_separator_line(const std::string &line);
+bool split_pipe(std::string_view line, std::string_view &left, std::string_view &right);
+bool is_separator_line(std::string_view line);
 TokenParseKind parse_positive_int_token(const std::string_view token, int &out_value, TokenParseErr &out_error);
+// Reads an int at pos like `istream >> int`: whitespace, optional sign, digits.
+// False if there's no number there or it doesn't fit an int.
+bool scan_int(std::string_view text, std::size_t &pos, int &out_value);
 
 // One of my extentions automatically puts the next comment. not sure why
 } // namespace nonogram::io::textformat
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace nonogram::core {
+
+// Fixed set of threads that run indexed jobs.
+// run() hands indices 0..count-1 out to the pool threads and the calling thread, and returns once all are done.
+// Worker ids passed to the job are 0..size()-1, the caller is always worker 0.
+class ThreadPool {
+  public:
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int size() const { return static_cast<int>(threads_.size()) + 1; }
+
+    void run(size_t count, const std::function<void(int worker, size_t index)> &job);
+
+  private:
+    void worker_loop(int worker);
+    void drain(int worker);
+
+    std::vector<std::thread> threads_;
+
+    std::mutex m_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::size_t generation_ = 0;
+    bool shutdown_ = false;
+
+    const std::function<void(int, size_t)> *job_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+    int busy_ = 0; // pool threads still inside the current run
+};
+
+} // namespace nonogram::core
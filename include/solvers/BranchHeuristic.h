@@ -0,0 +1,65 @@
+#pragma once
+
+#include "DPSearch.h"
+#include "DomainGrid.h"
+#include "LineAutomaton.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Which undecided cell the search branches on
+// FirstUnknown        - first undecided cell in row-major order
+// MostConstrainedLine - cell of the line with the fewest undecided cells, crossing line breaks ties
+// ProbeImpact         - cell whose two values fix the most other cells when propagated
+enum class BranchRule { FirstUnknown,
+                        MostConstrainedLine,
+                        ProbeImpact
+};
+
+// Which value of the branched cell is tried first
+// FilledFirst - Filled, then Empty
+// EmptyFirst  - Empty, then Filled
+// Feasibility - the value more of the completions of the cell's row and column agree on
+enum class ValueOrder { FilledFirst,
+                        EmptyFirst,
+                        Feasibility
+};
+
+const char *branch_rule_name(BranchRule rule);
+const char *value_order_name(ValueOrder order);
+
+struct BranchDecision {
+    int cell;
+    std::uint8_t first;  // value tried first
+    std::uint8_t second; // value tried once the first one fails
+};
+
+// Picks the branch of every search node. Holds per-search scratch, so every thread needs its own.
+class BranchHeuristic {
+  public:
+    BranchHeuristic(ValueOrder order, int R, int C);
+    virtual ~BranchHeuristic() = default;
+
+    // g must be at a propagation fixpoint. `from` is the cell of the enclosing branch, 0 at the top.
+    // Returns false once every cell is decided.
+    bool decide(SolveContext &ctx, DomainGrid &g, int from, BranchDecision &out);
+
+  protected:
+    // -1 if every cell is decided. May propagate through ctx but must leave g as it found it.
+    virtual int pick_cell(SolveContext &ctx, DomainGrid &g, int from) = 0;
+
+    // Undecided cells per row and column, recounted by count_unknowns()
+    void count_unknowns(const DomainGrid &g);
+    std::vector<int> row_unknown_;
+    std::vector<int> col_unknown_;
+
+  private:
+    std::uint8_t first_value(SolveContext &ctx, const DomainGrid &g, int cell);
+    double filled_share(SolveContext &ctx, const DomainGrid &g, bool is_row, int idx, int pos);
+
+    ValueOrder order_;
+    std::vector<double> filled_counts_;
+    std::vector<double> empty_counts_;
+};
+
+std::unique_ptr<BranchHeuristic> make_branch_heuristic(BranchRule rule, ValueOrder order, int R, int C);
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "DomainGrid.h"
+#include "LineAutomaton.h"
+#include "LineScheduler.h"
+#include "SolveBudget.h"
+#include "SolverStats.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class SearchWorker;
+class FailedLiteralProber;
+class BranchHeuristic;
+
+// What one search decision fixes
+// Cells - one cell, two branches
+// Lines - the whole row or column through the picked cell, whichever has fewer completions,
+//         one branch per completion. Falls back to the cell when both have more than kMaxLinePlacements.
+enum class BranchMode { Cells,
+                        Lines
+};
+
+const char *branch_mode_name(BranchMode mode);
+
+constexpr std::size_t kMaxLinePlacements = 64;
+
+// Line propagations and search steps between two looks at the clock
+constexpr std::uint32_t kBudgetPollInterval = 64;
+
+// One open branch of the search
+struct SearchFrame {
+    size_t trail_mark;        // trail size before the branch value was written
+    int cell;                 // flattened index of the branched cell, the picked cell for a line branch
+    std::uint8_t alternative; // value still to try, 0 once both are done
+
+    // line branches (line.idx >= 0): placements [next, end) of ctx.placements are still to try,
+    // the frame owns them from begin
+    LineRef line{true, -1};
+    size_t begin = 0;
+    size_t next = 0;
+    size_t end = 0;
+};
+
+// Everything one search needs besides the grid itself.
+// Sized once per puzzle in the constructor, after that propagations and search nodes reuse it without allocating.
+struct SolveContext {
+    const PuzzleAutomata &lines;
+    LineKernel kernel;
+
+    LineScratch scratch;
+    LineScheduler q;
+    std::vector<std::uint8_t> line_domains;
+    std::vector<std::uint8_t> new_line_domains;
+
+    // search state: undo log of domain writes plus one frame per open branch
+    Trail trail;
+    std::vector<SearchFrame> stack;
+
+    // line branching: completions of every open line branch back to back, and counts to pick the line
+    std::vector<std::uint8_t> placements;
+    std::vector<double> completions_filled;
+    std::vector<double> completions_empty;
+
+    // propagations, nodes, backtracks and depth of this context. Line propagations are the cost
+    // a LineSchedule tries to cut, nodes the cost a BranchRule tries to cut
+    SolverStats stats;
+
+    // limits of the running solve, null when it has none
+    SolveBudget *budget = nullptr;
+    std::size_t budget_nodes = 0; // stats.nodes already charged to the budget
+    std::uint32_t budget_polls = 0;
+
+    SolveContext(const PuzzleAutomata &lines, LineKernel kernel, LineSchedule schedule, int R, int C);
+
+    // stats plus the scheduler's push count, what this context adds to a solve's totals
+    SolverStats totals() const;
+};
+
+// Charges new search nodes to ctx.budget and reads its clock every kBudgetPollInterval calls.
+// True once the solve has to stop, always false without a budget.
+bool out_of_budget(SolveContext &ctx);
+
+// Propagates queued lines until nothing changes.
+// Returns false on contradiction, or once ctx.budget runs out (the caller tells the two apart by the budget).
+// The queue is empty either way, a contradiction drops whatever was left so the next propagation starts clean.
+bool propagate_queue(SolveContext &ctx, DomainGrid &g);
+
+// Queues every row and column, then propagates to the fixpoint
+bool enforce_arc_consistency(SolveContext &ctx, DomainGrid &g);
+
+// Writes a branch decision and restores the fixpoint.
+// The grid was already consistent, so only the row and column of the cell can start new changes.
+bool assign_and_propagate(SolveContext &ctx, DomainGrid &g, int cell, std::uint8_t value);
+
+// The row or column of cell with fewer completions, false if both have more than kMaxLinePlacements
+bool pick_branch_line(SolveContext &ctx, const DomainGrid &g, int cell, LineRef &out_line);
+
+// Writes a complete line and restores the fixpoint, values holds one value per cell of the line
+bool assign_line_and_propagate(SolveContext &ctx, DomainGrid &g, LineRef line, const std::uint8_t *values);
+
+// Pick the first cell with two possible values, -1 if every cell is decided.
+// Cells before the last branched cell are already decided, so the scan starts there.
+int pick_branch_cell(const DomainGrid &g, int from);
+
+// Optional pieces plugged into search_subtree, all may be null
+struct SearchHooks {
+    // parallel mode: open branches are handed to idle threads, the search gives up once the worker is told to stop
+    SearchWorker *worker = nullptr;
+    // probes every node before a cell is picked
+    FailedLiteralProber *prober = nullptr;
+    // picks the branch cell and value order, null means first unknown cell, Filled first
+    BranchHeuristic *brancher = nullptr;
+    BranchMode mode = BranchMode::Cells;
+    // called with every solution, returning true keeps searching for the next one from that leaf
+    std::function<bool(const DomainGrid &)> on_solution;
+};
+
+// Depth-first search below a grid that is already at a propagation fixpoint.
+// Branches write through ctx.trail and backtracking rolls the trail back,
+// so the search holds one grid plus the trail no matter how deep it goes.
+// Returns true with g solved at the first solution hooks.on_solution doesn't continue from,
+// false once the subtree is exhausted or ctx.budget runs out.
+bool search_subtree(SolveContext &ctx, DomainGrid &g, const SearchHooks &hooks = {});
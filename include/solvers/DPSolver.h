@@ -1,11 +1,128 @@
 #pragma once
 
 #include "../Nonogram.h"
+#include "BranchHeuristic.h"
+#include "FailedLiteralProber.h"
 #include "ISolverStrategy.h"
+#include "LineAutomaton.h"
+#include "LineScheduler.h"
+#include "SolveBudget.h"
+#include "SolverStats.h"
+#include <cstddef>
 #include <string>
+#include <utility>
+#include <vector>
 
-class DPSolver : ISolverStrategy {
+// Result of DPSolver::countSolutions
+struct SolutionCount {
+    int limit = 0;
+    int solutions = 0;      // found before the search stopped, at most limit
+    bool exhausted = false; // the whole tree was searched, so solutions is exact even below the limit
+    // (row, col) of the cells the first two solutions disagree on, empty with fewer than two
+    std::vector<std::pair<int, int>> distinguishing_cells;
+};
+
+class DPSolver : public ISolverStrategy {
   private:
+    LineKernel kernel_ = LineKernel::BitParallel;
+    LineSchedule schedule_ = LineSchedule::Fifo;
+    int threads_ = 1;
+    ProbeMode probe_mode_ = ProbeMode::Off;
+    BranchRule branch_rule_ = BranchRule::FirstUnknown;
+    ValueOrder value_order_ = ValueOrder::FilledFirst;
+    BranchMode branch_mode_ = BranchMode::Cells;
+    SolveLimits limits_;
+    SolveBudget *shared_budget_ = nullptr;
+    SolveStatus status_ = SolveStatus::Failed;
+    SolveCutoff cutoff_ = SolveCutoff::None;
+    SolverStats stats_;
+    std::size_t search_allocations_ = 0;
+
+    // Automata of the last puzzle seen and its clues, so propagate and the solve or count after it
+    // in one pipeline run compile every clue once
+    PuzzleAutomata automata_;
+    std::vector<std::vector<int>> automata_row_clues_;
+    std::vector<std::vector<int>> automata_col_clues_;
+    bool has_automata_ = false;
+
+    // Compiles puzzle's clues unless they're the ones automata_ was compiled from
+    const PuzzleAutomata &automata_for(const Nonogram &puzzle);
+
+    // Shared by solve and countSolutions. Returns false only for a puzzle it can't search,
+    // found says whether g now holds a solution. g is left alone when there is none.
+    // at_fixpoint: g is already at the line propagation fixpoint, the root propagation is skipped.
+    bool search(const Nonogram &puzzle, DomainGrid &g, SolutionCount *count, bool at_fixpoint, bool &found,
+                std::string &error);
+
   public:
-    bool solve(Nonogram &puzzle, std::string &error);
-};
\ No newline at end of file
+    bool solve(Nonogram &puzzle, std::string &error) override;
+
+    // Same on domains: g starts from whatever earlier strategies proved and holds the solution afterwards
+    // (or the proved cells of a stopped solve). at_fixpoint says g is already at the fixpoint of propagate(),
+    // e.g. the pipeline ran it last, so the search doesn't repeat the root propagation.
+    bool solve(const Nonogram &puzzle, DomainGrid &g, std::string &error, bool at_fixpoint = false);
+
+    // Pipeline step: line propagation of every row and column to the fixpoint, no search
+    LineResult propagate(const Nonogram &puzzle, DomainGrid &g, std::string &error) override;
+    const char *name() const override { return "dp-lines"; }
+
+    // How the last solve or count ended. A solve returns true only for Solved, TimedOut tells a cut off
+    // solve apart from one that proved there is no solution.
+    SolveStatus status() const;
+    // Limit that stopped the last solve, None unless status() is TimedOut
+    SolveCutoff cutoff() const;
+
+    // Deadline, node budget and cancellation token for the following solves, none by default.
+    // The search checks them every few propagations, so a solve stops within about a millisecond on
+    // ordinary sizes. A stopped solve leaves the cells the root propagation (and root probing) proved,
+    // the guesses of the search are rolled back.
+    void setLimits(const SolveLimits &limits);
+
+    // Budget of a larger solve this solver is one step of, used instead of setLimits while set.
+    // Must outlive the calls made with it, null to go back to setLimits.
+    void setSharedBudget(SolveBudget *budget);
+
+    // Propagation, probing and search counters plus the root propagation and search times of the last solve
+    const SolverStats &stats() const override;
+
+    // Counts solutions until limit of them are found or the search runs out.
+    // Continues from each solution leaf instead of restarting, so the propagation fixpoint is reused.
+    // Writes the first solution into puzzle.cells. No solution isn't an error here, the count is 0.
+    // Hitting a limit is: it returns false with status() TimedOut and out holds what was found so far.
+    // Always runs the search on one thread, probes still use the thread count.
+    bool countSolutions(Nonogram &puzzle, int limit, SolutionCount &out, std::string &error);
+    bool countSolutions(const Nonogram &puzzle, DomainGrid &g, int limit, SolutionCount &out, std::string &error,
+                        bool at_fixpoint = false);
+
+    // Inner loop of the line propagation, both kernels give the same result
+    void setLineKernel(LineKernel kernel);
+
+    // Order dirty lines are propagated in, Fifo by default
+    void setLineSchedule(LineSchedule schedule);
+
+    // Threads used by the search. Above 1 open subtrees are shared through work-stealing deques
+    // and the first thread to find a solution stops the others.
+    void setThreadCount(int threads);
+
+    // Failed-literal probing before branching, Off by default.
+    // Probes run on the solver's threads. With EveryNode the threads go to the probes and the search
+    // itself stays on one thread, with Root the threads probe the root and then share the search.
+    void setProbeMode(ProbeMode mode);
+
+    // Cell the search branches on and the value it tries first, FirstUnknown / FilledFirst by default
+    void setBranchRule(BranchRule rule);
+    void setValueOrder(ValueOrder order);
+
+    // Whether a decision fixes one cell or a whole line placement, Cells by default.
+    // With Lines the rule and value order above only apply when the search falls back to a cell.
+    void setBranchMode(BranchMode mode);
+
+    // Shorthands for stats().probe_fixed_cells, stats().line_propagations() and stats().nodes
+    std::size_t probeFixedCells() const;
+    std::size_t linePropagations() const;
+    std::size_t searchNodes() const;
+
+    // Heap allocations made by the last single-threaded search once its context was sized.
+    // Needs a build with -DNONOGRAM_COUNT_ALLOCATIONS, otherwise always 0.
+    std::size_t searchAllocations() const;
+};
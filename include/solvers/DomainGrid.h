@@ -0,0 +1,144 @@
+#pragma once
+
+#include "../Cell.h"
+#include "../CellGrid.h"
+#include "../Nonogram.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Domain bitmask per cell
+// bit0 (1) = Empty possible
+// bit1 (2) = Filled possible
+constexpr std::uint8_t D_EMPTY = 0x1;
+constexpr std::uint8_t D_FILLED = 0x2;
+
+inline std::uint8_t domain_from_cell(Cell c) {
+    switch (c) {
+    case Cell::Empty:
+        return D_EMPTY;
+    case Cell::Filled:
+        return D_FILLED;
+    case Cell::Unknown:
+    default:
+        return D_EMPTY | D_FILLED;
+    }
+}
+
+inline Cell cell_from_domain(std::uint8_t d) {
+    if (d == D_EMPTY)
+        return Cell::Empty;
+    if (d == D_FILLED)
+        return Cell::Filled;
+    return Cell::Unknown;
+}
+
+inline int popcount2(std::uint8_t d) {
+    // only need for {0..3}
+    return (d & 1 ? 1 : 0) + (d & 2 ? 1 : 0);
+}
+
+// Domains of the whole grid, stored as a CellGrid (Unknown = both values possible).
+// Rows and columns both read as contiguous words, so a column costs as much to load as a row.
+// Flat cell indices are row-major, index = r * C + c.
+struct DomainGrid {
+    int R = 0;
+    int C = 0;
+    CellGrid cells;
+
+    // R x C with both values possible everywhere
+    void resize(int rows, int cols) {
+        R = rows;
+        C = cols;
+        cells.assign(static_cast<size_t>(rows), static_cast<size_t>(cols));
+    }
+
+    std::uint8_t at(int r, int c) const {
+        const size_t w = static_cast<size_t>(c) / CellGrid::kWordBits;
+        const unsigned bit = static_cast<unsigned>(c) % CellGrid::kWordBits;
+        const unsigned known = static_cast<unsigned>((cells.row_filled(r)[w] >> bit) & 1) << 1 |
+                               static_cast<unsigned>((cells.row_empty(r)[w] >> bit) & 1);
+        return static_cast<std::uint8_t>(known ? known : D_EMPTY | D_FILLED);
+    }
+    std::uint8_t get(int index) const { return at(index / C, index % C); }
+
+    // value must not be 0, a contradiction is never stored
+    void set(int r, int c, std::uint8_t value) { cells.set(r, c, cell_from_domain(value)); }
+    void set(int index, std::uint8_t value) { set(index / C, index % C, value); }
+
+    // Domains of row (is_row) or column idx into out, C or R of them
+    void read_line(bool is_row, int idx, std::uint8_t *out) const {
+        const CellGrid::Word *filled = is_row ? cells.row_filled(idx) : cells.col_filled(idx);
+        const CellGrid::Word *empty = is_row ? cells.row_empty(idx) : cells.col_empty(idx);
+        const size_t len = static_cast<size_t>(is_row ? C : R);
+        for (size_t w = 0; w * CellGrid::kWordBits < len; ++w) {
+            const CellGrid::Word f = filled[w];
+            const CellGrid::Word e = empty[w];
+            const size_t n = std::min(CellGrid::kWordBits, len - w * CellGrid::kWordBits);
+            std::uint8_t *dst = out + w * CellGrid::kWordBits;
+            for (size_t b = 0; b < n; ++b) {
+                const unsigned known = static_cast<unsigned>((f >> b) & 1) << 1 | static_cast<unsigned>((e >> b) & 1);
+                dst[b] = static_cast<std::uint8_t>(known ? known : D_EMPTY | D_FILLED);
+            }
+        }
+    }
+
+    bool all_singleton() const { return cells.unknown_count() == 0; }
+
+    void swap(DomainGrid &other) noexcept {
+        std::swap(R, other.R);
+        std::swap(C, other.C);
+        cells.swap(other.cells);
+    }
+};
+
+// Domains of puzzle.cells, puzzle.cells must be rows() x cols()
+inline DomainGrid domains_from_cells(const Nonogram &puzzle) {
+    DomainGrid g;
+    g.R = static_cast<int>(puzzle.rows());
+    g.C = static_cast<int>(puzzle.cols());
+    g.cells = puzzle.cells;
+    return g;
+}
+
+inline void write_cells(const DomainGrid &g, Nonogram &puzzle) {
+    puzzle.cells = g.cells;
+}
+
+// Cells with both values still possible
+inline size_t unknown_cells(const DomainGrid &g) {
+    return g.cells.unknown_count();
+}
+
+// Undo log of domain changes.
+// The search records every write here and rolls back to a mark on backtrack instead of copying the grid per branch.
+class Trail {
+  public:
+    void reserve(size_t n) { entries_.reserve(n); }
+    void clear() { entries_.clear(); }
+    size_t mark() const { return entries_.size(); }
+    // Cell written by entry i, entries past a mark are the changes made since it
+    int index_at(size_t i) const { return entries_[i].index; }
+
+    void set(DomainGrid &g, int index, std::uint8_t value) {
+        entries_.push_back({index, g.get(index)});
+        g.set(index, value);
+    }
+
+    void undo_to(DomainGrid &g, size_t mark) {
+        while (entries_.size() > mark) {
+            const Entry &e = entries_.back();
+            g.set(e.index, e.old_value);
+            entries_.pop_back();
+        }
+    }
+
+  private:
+    struct Entry {
+        int index;
+        std::uint8_t old_value;
+    };
+    std::vector<Entry> entries_;
+};
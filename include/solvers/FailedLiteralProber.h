@@ -0,0 +1,72 @@
+#pragma once
+
+#include "../core/ThreadPool.h"
+#include "DPSearch.h"
+#include "DomainGrid.h"
+#include "LineAutomaton.h"
+#include "LineScheduler.h"
+#include "SolverStats.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// When the search runs a failed-literal probing pass
+// Off       - never
+// Root      - once, after the root propagation
+// EveryNode - at every search node before a cell is picked
+enum class ProbeMode { Off,
+                       Root,
+                       EveryNode
+};
+
+const char *probe_mode_name(ProbeMode mode);
+
+// Failed-literal probing.
+// Every undecided cell is tentatively set to Filled and to Empty and propagated.
+// A value that leads to a contradiction is ruled out, and cells both probes fix to the same value are fixed.
+// Probes of one round all start from the same grid, so they're spread over the thread pool.
+class FailedLiteralProber {
+  public:
+    // pool may be null, probes then run on the calling thread
+    FailedLiteralProber(const PuzzleAutomata &lines, LineKernel kernel, LineSchedule schedule,
+                        int R, int C, nonogram::core::ThreadPool *pool);
+
+    // g must be at a propagation fixpoint. Writes what the probes prove through ctx (trail + propagation)
+    // and repeats until a round learns nothing. Returns false if g has no solution, or once budget runs out.
+    bool run(SolveContext &ctx, DomainGrid &g);
+
+    // Limits the probes' own propagations, null for none
+    void set_budget(SolveBudget *budget);
+
+    std::size_t probes() const { return probes_; }
+    std::size_t fixed_cells() const { return fixed_cells_; }
+
+    // Propagation work of every probe thread plus fixed_cells(). The propagations run through the
+    // ctx given to run() are counted there.
+    SolverStats stats() const;
+
+  private:
+    struct ProbeWorker {
+        SolveContext ctx;
+        DomainGrid g;
+        std::vector<std::uint32_t> stamp;      // probe id that last set seen_value
+        std::vector<std::uint8_t> seen_value;  // value a cell took in the Filled probe
+        std::vector<std::pair<int, std::uint8_t>> implied;
+        bool contradiction = false;
+        std::uint32_t probe_id = 0;
+
+        ProbeWorker(const PuzzleAutomata &lines, LineKernel kernel, LineSchedule schedule, int R, int C)
+            : ctx(lines, kernel, schedule, R, C) {}
+    };
+
+    void probe_cell(ProbeWorker &w, int cell);
+
+    nonogram::core::ThreadPool *pool_;
+    SolveBudget *budget_ = nullptr;
+    std::vector<std::unique_ptr<ProbeWorker>> workers_;
+    std::vector<int> unknown_;
+    std::size_t probes_ = 0;
+    std::size_t fixed_cells_ = 0;
+};
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "../Nonogram.h"
+#include "../core/enums.h"
+#include "DomainGrid.h"
+#include "SolverStats.h"
 #include <string>
 
 class ISolverStrategy {
@@ -8,4 +11,15 @@ class ISolverStrategy {
     virtual ~ISolverStrategy() = default;
 
     virtual bool solve(Nonogram &puzzle, std::string &error) = 0;
+
+    // Pipeline step on domains shared with the other strategies, see NonogramSolver.
+    // Only ever narrows g and runs to its own fixpoint, so a second call on its own output changes nothing.
+    // Changed if a cell lost a value, Contradiction (with error) if the clues can't hold.
+    virtual LineResult propagate(const Nonogram &puzzle, DomainGrid &g, std::string &error) = 0;
+
+    // Short name for stats and logs
+    virtual const char *name() const = 0;
+
+    // What the last solve or propagate did, each strategy fills in the fields it has a part in
+    virtual const SolverStats &stats() const = 0;
 };
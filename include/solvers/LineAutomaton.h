@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../Nonogram.h"
+#include "DomainGrid.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Inner loop used by propagate_line_domains.
+// Scalar walks the states one byte at a time, BitParallel packs the state set into 64-bit words.
+enum class LineKernel { Scalar,
+                        BitParallel
+};
+
+// Position-indexed automaton for one line clue, compiled once per puzzle.
+// State k means the first k symbols of the tightest packing "1^c1 0 1^c2 0 ... 1^cM" have been placed,
+// so a clue has sum(clues) + M states (one state for an empty clue list).
+// Every state has at most one successor per cell value:
+//   advance k -> k+1 when the value matches symbol k
+//   stay    k -> k   on Empty while in a gap (before the first block, after a separator, after the last block)
+class LineAutomaton {
+  public:
+    LineAutomaton() = default;
+    explicit LineAutomaton(const std::vector<int> &clues);
+
+    // Accepting state, also the length of the tightest packing.
+    int length() const { return static_cast<int>(symbol_.size()); }
+    int state_count() const { return length() + 1; }
+    bool valid() const { return valid_; }
+
+    // True if a line of singleton domains spells out exactly this clue
+    bool accepts(const std::vector<std::uint8_t> &values) const;
+
+    // Word-packed state masks for the bit-parallel kernel, bit k of word k / 64 is state k.
+    int word_count() const { return static_cast<int>(fill_mask_.size()); }
+    const std::uint64_t *fill_mask() const { return fill_mask_.data(); }   // Filled advances k -> k+1
+    const std::uint64_t *empty_mask() const { return empty_mask_.data(); } // Empty advances k -> k+1
+    const std::uint64_t *gap_mask() const { return gap_mask_.data(); }     // Empty stays on k
+
+    // Successor of state k on a single value (D_EMPTY or D_FILLED), -1 if the value is not allowed.
+    int next(int k, std::uint8_t value) const {
+        if (k < length() && symbol_[k] == value)
+            return k + 1;
+        if (value == D_EMPTY && gap_[k])
+            return k;
+        return -1;
+    }
+
+  private:
+    std::vector<std::uint8_t> symbol_; // value that advances state k, size length()
+    std::vector<std::uint8_t> gap_;    // 1 where Empty loops on state k, size state_count()
+    std::vector<std::uint64_t> fill_mask_;
+    std::vector<std::uint64_t> empty_mask_;
+    std::vector<std::uint64_t> gap_mask_;
+    bool valid_ = true;
+};
+
+// Compiled automata for every row and column of one puzzle.
+struct PuzzleAutomata {
+    std::vector<LineAutomaton> rows;
+    std::vector<LineAutomaton> cols;
+};
+
+PuzzleAutomata compile_automata(const Nonogram &puzzle);
+
+// Working memory for propagate_line_domains.
+// reserve() sizes it once for the largest line of a puzzle, after that propagations never touch the heap.
+struct LineScratch {
+    std::vector<std::uint8_t> forward;
+    std::vector<std::uint8_t> backward_cur;
+    std::vector<std::uint8_t> backward_next;
+
+    std::vector<std::uint64_t> forward_words;
+    std::vector<std::uint64_t> backward_cur_words;
+    std::vector<std::uint64_t> backward_next_words;
+
+    // count_line_completions, same window layout as the scalar kernel
+    std::vector<double> forward_counts;
+    std::vector<double> backward_cur_counts;
+    std::vector<double> backward_next_counts;
+
+    void reserve(const PuzzleAutomata &automata);
+};
+
+// Per-line propagation using reachability through the line automaton.
+// Returns false on contradiction (no valid completion), else true and fills out_new_domains.
+// Both kernels produce the same out_new_domains.
+bool propagate_line_domains(const LineAutomaton &automaton,
+                            const std::vector<std::uint8_t> &in_domains,
+                            std::vector<std::uint8_t> &out_new_domains,
+                            LineScratch &scratch,
+                            LineKernel kernel = LineKernel::BitParallel);
+
+// Counts the valid completions of a line, split per cell by the value the cell takes in them.
+// out_filled[i] / out_empty[i] = completions with cell i Filled / Empty. Counts grow exponentially
+// with the line length, so they're doubles and only meant for comparing.
+// Returns false if the line has no completion.
+bool count_line_completions(const LineAutomaton &automaton,
+                            const std::vector<std::uint8_t> &in_domains,
+                            std::vector<double> &out_filled,
+                            std::vector<double> &out_empty,
+                            LineScratch &scratch);
+
+// Appends every valid completion of the line to out, in_domains.size() values each, Empty before Filled
+// position by position. Returns how many were appended, 0 if the line has none.
+// Meant for lines count_line_completions already found to have few completions.
+size_t enumerate_line_completions(const LineAutomaton &automaton,
+                                  const std::vector<std::uint8_t> &in_domains,
+                                  std::vector<std::uint8_t> &out,
+                                  LineScratch &scratch);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "LineAutomaton.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Order in which enforce_arc_consistency takes dirty lines off its queue.
+// Fifo          - insertion order
+// MostChanged   - line with the most cells changed since it was queued
+// LeastSlack    - line whose clue leaves the least room to slide (most constrained)
+// CheapestFirst - line with the smallest estimated DP cost (length x state window)
+enum class LineSchedule { Fifo,
+                          MostChanged,
+                          LeastSlack,
+                          CheapestFirst
+};
+
+const char *line_schedule_name(LineSchedule schedule);
+
+struct LineRef { bool is_row; int idx; };
+
+// Queue of dirty lines, a line is queued at most once at a time.
+// Sized once in reset(), push/pop never allocate.
+class LineScheduler {
+  public:
+    void reset(LineSchedule policy, const PuzzleAutomata &lines);
+
+    bool empty() const { return size_ == 0; }
+
+    // Queues the line, or counts one more changed cell on it if it's already queued
+    void push(LineRef line);
+    LineRef pop();
+    void clear();
+
+    // push calls since reset()
+    std::size_t pushes() const { return pushes_; }
+
+  private:
+    int id_of(LineRef line) const { return line.is_row ? line.idx : rows_ + line.idx; }
+    LineRef ref_of(int id) const { return id < rows_ ? LineRef{true, id} : LineRef{false, id - rows_}; }
+
+    bool before(int a, int b) const;
+    void sift_up(size_t pos);
+    void sift_down(size_t pos);
+
+    LineSchedule policy_ = LineSchedule::Fifo;
+    int rows_ = 0;
+    size_t size_ = 0;
+    std::size_t pushes_ = 0;
+
+    // Fifo: ring of line ids
+    std::vector<int> ring_;
+    size_t head_ = 0;
+
+    // Scored policies: binary max-heap of line ids, heap_pos_[id] = index in heap_ or -1
+    std::vector<int> heap_;
+    std::vector<int> heap_pos_;
+    std::vector<std::int64_t> score_;
+    std::vector<std::int64_t> static_score_;
+};
@@ -1,19 +1,94 @@
 #pragma once
 
 #include "../../include/solvers/DPSolver.h"
+#include "../../include/solvers/OverlapLineSolver.h"
+#include "../../include/solvers/SolverStats.h"
 #include "../../include/solvers/TrivialConstraintsSolver.h"
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <vector>
 
 class Nonogram;
 class ISolverStrategy;
+class SolutionCache;
 
+// Runs the propagation strategies on one shared DomainGrid until none of them changes a cell, then
+// searches from that fixpoint with the DP solver. Strategies run in the order they were added, cheapest
+// first, and a strategy that makes progress sends the loop back to the first one, so the cheap rules
+// take what they can before the next expensive one runs.
+// Default pipeline: TrivialConstraintsSolver, OverlapLineSolver, then DP line propagation.
 class NonogramSolver {
   public:
     NonogramSolver();
     bool solve(Nonogram &puzzle, std::string &error);
 
+    // Adds a propagation strategy to the pipeline, after the ones added before it and ahead of the
+    // DP line propagation, which always runs last since the search continues from its fixpoint
+    void addStrategy(std::unique_ptr<ISolverStrategy> strategy);
+
+    // How the last solve or count ended, see DPSolver::status
+    SolveStatus status() const { return status_; }
+
+    // Deadline, node budget and cancellation token for the DP solver, see DPSolver::setLimits
+    void setLimits(const SolveLimits &limits);
+
+    // Uniqueness check: counts solutions up to limit (2 answers "is it unique"), see DPSolver::countSolutions.
+    // out.distinguishing_cells lists where the first two solutions differ.
+    bool countSolutions(Nonogram &puzzle, int limit, SolutionCount &out, std::string &error);
+
+    // Solution cache solve() looks in first and saves solved puzzles to, nullptr (the default) for none.
+    // A hit skips the pipeline and the search. countSolutions doesn't use it.
+    void setCache(SolutionCache *cache);
+
+    // Line scheduling policy handed to the DP solver
+    void setLineSchedule(LineSchedule schedule);
+
+    // Threads the DP search may use, 1 by default
+    void setThreadCount(int threads);
+
+    // Failed-literal probing in the DP solver, see DPSolver::setProbeMode
+    void setProbeMode(ProbeMode mode);
+
+    // Branching heuristic of the DP search, see DPSolver::setBranchRule
+    void setBranchRule(BranchRule rule);
+    void setValueOrder(ValueOrder order);
+    void setBranchMode(BranchMode mode);
+
+    // Everything the last solve or count did, summed over the pipeline and the DP search
+    const SolverStats &stats() const { return stats_; }
+
+    // Per pipeline strategy, in pipeline order
+    const std::vector<StrategyStats> &strategyStats() const { return strategy_stats_; }
+
+    // Shorthands for stats().line_propagations() and stats().nodes
+    std::size_t linePropagations() const;
+    std::size_t searchNodes() const;
+
+    // Heap allocations made by the DP search of the last solve, see DPSolver::searchAllocations
+    std::size_t searchAllocations() const;
+
   private:
-    std::vector<std::unique_ptr<ISolverStrategy>> strategies_;
+    // Prepares puzzle and g for a solve or count, then runs the pipeline.
+    // False when the puzzle can't be searched or the pipeline already settled it (status_ says how).
+    // out_at_fixpoint says g is at the DP line propagation fixpoint, so the search can skip its root propagation.
+    bool start(Nonogram &puzzle, DomainGrid &g, SolveBudget &budget, bool &out_at_fixpoint, std::string &out_error);
+    LineResult run_pipeline(const Nonogram &puzzle, DomainGrid &g, const SolveBudget &budget, bool &out_at_fixpoint,
+                            std::string &out_error);
+    void configure(DPSolver &strategy, SolveBudget *budget);
+
+    std::vector<std::unique_ptr<ISolverStrategy>> strategies_; // the DP solver is the last one
+    DPSolver *dp_ = nullptr;
+    LineSchedule schedule_ = LineSchedule::Fifo;
+    int threads_ = 1;
+    ProbeMode probe_mode_ = ProbeMode::Off;
+    BranchRule branch_rule_ = BranchRule::FirstUnknown;
+    ValueOrder value_order_ = ValueOrder::FilledFirst;
+    BranchMode branch_mode_ = BranchMode::Cells;
+    SolveLimits limits_;
+    SolutionCache *cache_ = nullptr;
+    SolveStatus status_ = SolveStatus::Failed;
+    std::size_t search_allocations_ = 0;
+    SolverStats stats_;
+    std::vector<StrategyStats> strategy_stats_;
 };
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../Nonogram.h"
+#include "../core/enums.h"
+#include "DomainGrid.h"
+#include "ISolverStrategy.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Left/right overlap on every line against the current cells.
+// Finds the leftmost and rightmost placement of each block that avoids Empty cells and covers every
+// Filled cell. Cells all placements of a block cover are Filled (simple boxes), cells no block can reach
+// are Empty (simple spaces). Not complete like the DP line solver, but linear in the line length plus the
+// clue count for typical lines, with no automaton to build.
+// Lines are rechecked whenever a crossing line changed one of their cells, until nothing changes.
+class OverlapLineSolver : public ISolverStrategy {
+  public:
+    bool solve(Nonogram &puzzle, std::string &error) override;
+    LineResult propagate(const Nonogram &puzzle, DomainGrid &g, std::string &error) override;
+    const char *name() const override { return "overlap"; }
+    const SolverStats &stats() const override { return stats_; }
+
+  private:
+    // Every line until none changes, propagate times it
+    LineResult sweep(const Nonogram &puzzle, DomainGrid &g, std::string &error);
+    // One line, in place. Contradiction if no placement fits the cells.
+    LineResult solve_line(const std::vector<int> &clues, std::vector<std::uint8_t> &line);
+
+    SolverStats stats_;
+
+    // scratch reused by every line
+    std::vector<int> left_;
+    std::vector<int> right_;
+    std::vector<int> reversed_clues_;
+    std::vector<std::uint8_t> reversed_line_;
+    std::vector<int> next_filled_;
+    std::vector<int> next_empty_;
+    std::vector<std::uint8_t> line_;
+};
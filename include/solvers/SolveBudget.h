@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+
+// How a solve ended
+// Solved     - puzzle.cells holds a solution
+// NoSolution - the search ran out, the clues contradict each other
+// TimedOut   - a SolveLimits limit stopped it, puzzle.cells holds the cells propagation proved before the search
+// Failed     - the puzzle couldn't be searched (e.g. zero size)
+enum class SolveStatus { Solved,
+                         NoSolution,
+                         TimedOut,
+                         Failed
+};
+
+// Which limit stopped a solve
+enum class SolveCutoff { None,
+                         Deadline,
+                         NodeBudget,
+                         Cancelled
+};
+
+// solved, unsolved, timed_out or failed, the statuses batch and bench records use
+const char *solve_status_name(SolveStatus status);
+const char *solve_cutoff_name(SolveCutoff cutoff);
+
+// Set from any thread to stop the solves that were given the token
+class CancellationToken {
+  public:
+    void cancel() { cancelled_.store(true, std::memory_order_relaxed); }
+    void reset() { cancelled_.store(false, std::memory_order_relaxed); }
+    bool cancelled() const { return cancelled_.load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<bool> cancelled_{false};
+};
+
+// Limits of one solve, 0 / null means no limit
+struct SolveLimits {
+    double timeout_ms = 0.0;                    // wall clock from the start of the DP solve
+    std::size_t node_budget = 0;                // branch values the search may try, over all threads
+    const CancellationToken *cancel = nullptr; // must outlive the solve
+
+    bool limited() const { return timeout_ms > 0.0 || node_budget > 0 || cancel; }
+};
+
+// SolveLimits of one running solve, shared by all its threads. Once a limit is hit it stays stopped.
+// The clock and the token are only read by poll(), stopped() is a single relaxed load.
+class SolveBudget {
+  public:
+    // The clock starts here
+    explicit SolveBudget(const SolveLimits &limits);
+
+    bool stopped() const { return cutoff_.load(std::memory_order_relaxed) != static_cast<int>(SolveCutoff::None); }
+    SolveCutoff cutoff() const { return static_cast<SolveCutoff>(cutoff_.load(std::memory_order_relaxed)); }
+
+    // Reads the clock and the token, returns true once the solve has to stop
+    bool poll();
+
+    // Charges search nodes against the node budget, returns true once the solve has to stop
+    bool add_nodes(std::size_t nodes);
+
+  private:
+    void stop(SolveCutoff cutoff);
+
+    SolveLimits limits_;
+    std::chrono::steady_clock::time_point deadline_;
+    std::atomic<std::size_t> nodes_{0};
+    std::atomic<int> cutoff_{static_cast<int>(SolveCutoff::None)};
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "BranchHeuristic.h"
+#include "FailedLiteralProber.h"
+#include "LineScheduler.h"
+#include <string>
+
+class NonogramSolver;
+
+// NonogramSolver settings as the command line tools (app, bench) take them
+//   --schedule fifo|most-changed|least-slack|cheapest
+//   --search-threads N
+//   --probe off|root|every
+//   --branch first|constrained|probe
+//   --value filled|empty|feasibility
+//   --branch-mode cells|lines
+struct SolverOptions {
+    LineSchedule schedule = LineSchedule::Fifo;
+    int threads = 1; // of the DP search, see NonogramSolver::setThreadCount
+    ProbeMode probe_mode = ProbeMode::Off;
+    BranchRule branch_rule = BranchRule::FirstUnknown;
+    ValueOrder value_order = ValueOrder::FilledFirst;
+    BranchMode branch_mode = BranchMode::Cells;
+};
+
+// Hands options to solver's setters
+void apply_solver_options(NonogramSolver &solver, const SolverOptions &options);
+
+// True if arg is one of the options above, they all take a value
+bool is_solver_option(const std::string &arg);
+
+// Reads the value of option arg into options. Returns false with out_error for a value it doesn't know.
+bool parse_solver_option(const std::string &arg, const std::string &value, SolverOptions &options,
+                         std::string &out_error);
+
+// "schedule fifo, search threads 1, probe off, branch first-unknown/filled-first on cells", the names of the settings for reports
+std::string describe_solver_options(const SolverOptions &options);
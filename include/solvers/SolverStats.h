@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+// Time and yield of one NonogramSolver pipeline strategy over a solve
+struct StrategyStats {
+    const char *name = "";
+    std::size_t runs = 0;        // propagate calls
+    std::size_t fixed_cells = 0; // cells those calls decided
+    double ms = 0.0;
+};
+
+// What a solve did, filled in by every strategy that took part.
+// The counters are plain increments on state each thread owns and are only summed once a search is over,
+// so they're always on.
+struct SolverStats {
+    // propagate_line_domains calls, fully decided lines are only checked and not counted
+    std::size_t row_propagations = 0;
+    std::size_t col_propagations = 0;
+    // lines handed to the LineScheduler, a push of a line that's already queued counts too
+    std::size_t queue_pushes = 0;
+
+    // cells decided, by who decided them
+    std::size_t trivial_fixed_cells = 0; // TrivialConstraintsSolver
+    std::size_t overlap_fixed_cells = 0; // OverlapLineSolver
+    std::size_t root_fixed_cells = 0;    // DP root propagation
+    std::size_t probe_fixed_cells = 0;   // failed-literal probes, before their own propagation
+
+    // search
+    std::size_t nodes = 0;      // branch values tried
+    std::size_t backtracks = 0; // dead ends the search backed out of
+    std::size_t max_depth = 0;  // most branches open at once. With threads, below the subtree a thread took
+
+    // wall time
+    double trivial_ms = 0.0;         // TrivialConstraintsSolver pass
+    double overlap_ms = 0.0;         // OverlapLineSolver passes
+    double arc_consistency_ms = 0.0; // DP root propagation
+    double search_ms = 0.0;          // root probing and search below the root
+
+    // solves answered by a SolutionCache, which leave every other counter at 0
+    std::size_t cache_hits = 0;
+
+    std::size_t line_propagations() const { return row_propagations + col_propagations; }
+
+    void add(const SolverStats &other) {
+        row_propagations += other.row_propagations;
+        col_propagations += other.col_propagations;
+        queue_pushes += other.queue_pushes;
+        trivial_fixed_cells += other.trivial_fixed_cells;
+        overlap_fixed_cells += other.overlap_fixed_cells;
+        root_fixed_cells += other.root_fixed_cells;
+        probe_fixed_cells += other.probe_fixed_cells;
+        nodes += other.nodes;
+        backtracks += other.backtracks;
+        max_depth = std::max(max_depth, other.max_depth);
+        trivial_ms += other.trivial_ms;
+        overlap_ms += other.overlap_ms;
+        arc_consistency_ms += other.arc_consistency_ms;
+        search_ms += other.search_ms;
+        cache_hits += other.cache_hits;
+    }
+};
@@ -8,6 +8,11 @@
 class TrivialConstraintsSolver : public ISolverStrategy {
   public:
     bool solve(Nonogram &puzzle, std::string &error) override;
+    // Exact-fit and empty lines, a single pass: it only looks at clues, so a second run finds nothing new
+    LineResult propagate(const Nonogram &puzzle, DomainGrid &g, std::string &error) override;
+    const char *name() const override { return "trivial"; }
+    const SolverStats &stats() const override { return stats_; }
 
   private:
+    SolverStats stats_;
 };
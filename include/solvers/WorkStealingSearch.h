@@ -0,0 +1,103 @@
+#pragma once
+
+#include "BranchHeuristic.h"
+#include "DomainGrid.h"
+#include "LineAutomaton.h"
+#include "LineScheduler.h"
+#include "SolveBudget.h"
+#include "SolverStats.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// An open subtree handed between threads: a fixpoint grid plus the decision that starts it.
+// cell < 0 means the grid still needs its root propagation, unless at_fixpoint says it's had it.
+struct SearchTask {
+    DomainGrid grid;
+    int cell = -1;
+    std::uint8_t value = 0;
+    bool at_fixpoint = false;
+};
+
+class WorkStealingPool;
+
+// One thread's view of the pool, handed to search_subtree
+class SearchWorker {
+  public:
+    SearchWorker(WorkStealingPool &pool, int id) : pool_(pool), id_(id) {}
+
+    bool should_stop() const;
+    // True when another thread is idle and this worker has nothing queued for it
+    bool wants_work() const;
+    // Queues the subtree "g with cell = value" on this worker's deque
+    void donate(const DomainGrid &g, int cell, std::uint8_t value);
+    // Queues the subtree "g with the whole line set to values", it starts with a full propagation
+    void donate_line(const DomainGrid &g, LineRef line, const std::uint8_t *values);
+
+  private:
+    WorkStealingPool &pool_;
+    int id_;
+};
+
+// Shared state of a parallel search.
+// Every worker owns a deque of open subtrees, it pops its newest task and steals the oldest
+// (largest) one from another worker when it runs dry. The first solution found stops everyone.
+class WorkStealingPool {
+  public:
+    explicit WorkStealingPool(int threads);
+
+    void push(int worker, SearchTask task);
+    bool take(int worker, SearchTask &out_task);
+    size_t queued(int worker) const;
+
+    // Tasks pushed but not finished yet, the search is over when this reaches 0
+    void finish_task();
+    bool exhausted() const { return pending_.load() == 0; }
+
+    // Blocks an idle worker (set_idle(true) first) until a task is queued, the search is over or timeout passes.
+    // The timeout only matters for a budget running out, everything else wakes the waiters.
+    void wait_for_work(std::chrono::milliseconds timeout);
+
+    void set_idle(bool idle) { idle_.fetch_add(idle ? 1 : -1); }
+    bool has_idle() const { return idle_.load(std::memory_order_relaxed) > 0; }
+
+    bool stopped() const { return stop_.load(std::memory_order_relaxed); }
+    // Keeps the first solution offered and stops the search, false if another thread was first
+    bool publish(const DomainGrid &g);
+    bool found() const { return found_; }
+    const DomainGrid &solution() const { return solution_; }
+
+  private:
+    struct WorkerQueue {
+        mutable std::mutex m;
+        std::deque<SearchTask> tasks;
+    };
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<int> idle_{0};
+    std::atomic<bool> stop_{false};
+
+    // idle workers sleep here, push() wakes one when someone is idle, the end of the search wakes them all
+    std::mutex wait_mutex_;
+    std::condition_variable work_ready_;
+    bool has_queued() const;
+    void wake_all();
+
+    std::mutex solution_mutex_;
+    bool found_ = false;
+    DomainGrid solution_;
+};
+
+// Solves g, which must be at a propagation fixpoint, on `threads` threads, each with its own heuristic
+// for rule and order and branching by mode. On success g holds the solution.
+// Adds the search stats of every thread to out_stats. budget (may be null) stops every thread once it runs out.
+bool work_stealing_search(const PuzzleAutomata &lines, LineKernel kernel, LineSchedule schedule,
+                          BranchRule rule, ValueOrder order, BranchMode mode, DomainGrid &g, int threads,
+                          SolveBudget *budget, SolverStats &out_stats);
@@ -0,0 +1,31 @@
+@echo off
+setlocal EnableExtensions EnableDelayedExpansion
+
+REM Run from the folder this .bat is in (project root)
+cd /d "%~dp0"
+
+set "CXX=g++"
+set "CXXFLAGS=-std=c++17 -Wall -Wextra -pedantic -O2 -pthread"
+set "INCLUDES=-Iinclude"
+set "LIBS=-lgdi32"
+set "OUT=bench.exe"
+set "MAIN=bench/bench.cpp"
+
+set "SRCS=%MAIN%"
+for /r "src" %%F in (*.cpp) do (
+  set "SRCS=!SRCS! "%%F""
+)
+
+echo Building...
+%CXX% %CXXFLAGS% %INCLUDES% %SRCS% -o "%OUT%" %LIBS%
+if errorlevel 1 (
+  echo.
+  echo Build failed.
+  exit /b 1
+)
+
+echo.
+echo Running...
+REM 0006 has no solution and the search takes very long, the default --timeout reports it as timed_out
+REM e.g. runBench.bat --json base.json, later runBench.bat --baseline base.json --threshold 10
+"%OUT%" %*
@@ -0,0 +1,30 @@
+@echo off
+setlocal EnableExtensions EnableDelayedExpansion
+
+REM Run from the folder this .bat is in (project root)
+cd /d "%~dp0"
+
+set "CXX=g++"
+set "CXXFLAGS=-std=c++17 -Wall -Wextra -pedantic -O2 -pthread"
+set "INCLUDES=-Iinclude"
+set "LIBS=-lgdi32"
+set "OUT=convert.exe"
+set "MAIN=tools/convert.cpp"
+
+set "SRCS=%MAIN%"
+for /r "src" %%F in (*.cpp) do (
+  set "SRCS=!SRCS! "%%F""
+)
+
+echo Building...
+%CXX% %CXXFLAGS% %INCLUDES% %SRCS% -o "%OUT%" %LIBS%
+if errorlevel 1 (
+  echo.
+  echo Build failed.
+  exit /b 1
+)
+
+echo.
+echo Running...
+REM e.g. runConverter.bat puzzles/0002.txt puzzles/0002.ngb, or runConverter.bat puzzles binary
+"%OUT%" %*
@@ -0,0 +1,30 @@
+@echo off
+setlocal EnableExtensions EnableDelayedExpansion
+
+REM Run from the folder this .bat is in (project root)
+cd /d "%~dp0"
+
+set "CXX=g++"
+set "CXXFLAGS=-std=c++17 -Wall -Wextra -pedantic -O2 -pthread"
+set "INCLUDES=-Iinclude"
+set "LIBS=-lgdi32"
+set "OUT=generate.exe"
+set "MAIN=tools/generate.cpp"
+
+set "SRCS=%MAIN%"
+for /r "src" %%F in (*.cpp) do (
+  set "SRCS=!SRCS! "%%F""
+)
+
+echo Building...
+%CXX% %CXXFLAGS% %INCLUDES% %SRCS% -o "%OUT%" %LIBS%
+if errorlevel 1 (
+  echo.
+  echo Build failed.
+  exit /b 1
+)
+
+echo.
+echo Running...
+REM e.g. runGenerator.bat --size 1000 --pattern blocks --out puzzles/big.txt
+"%OUT%" %*
@@ -5,8 +5,10 @@ REM Run from the folder this .bat is in (project root)
 cd /d "%~dp0"
 
 set "CXX=g++"
-set "CXXFLAGS=-std=c++17 -Wall -Wextra -pedantic -O0 -g"
+set "CXXFLAGS=-std=c++17 -Wall -Wextra -pedantic -O0 -g -pthread"
 set "INCLUDES=-Iinclude"
+REM Add -DNONOGRAM_COUNT_ALLOCATIONS to DEFINES to count heap allocations made by the search
+set "DEFINES="
 set "LIBS=-lgdi32"
 set "OUT=app.exe"
 set "MAIN=app/app.cpp"
@@ -18,7 +20,7 @@ for /r "src" %%F in (*.cpp) do (
 )
 
 echo Building...
-%CXX% %CXXFLAGS% %INCLUDES% %SRCS% -o "%OUT%" %LIBS%
+%CXX% %CXXFLAGS% %DEFINES% %INCLUDES% %SRCS% -o "%OUT%" %LIBS%
 if errorlevel 1 (
   echo.
   echo Build failed.
@@ -27,4 +29,5 @@ if errorlevel 1 (
 
 echo.
 echo Running...
-"%OUT%"
+REM Arguments are passed on, e.g. runSolver.bat --batch puzzles --threads 8 --format jsonl
+"%OUT%" %*
@@ -0,0 +1,139 @@
+// CellGrid.cpp
+#include "../include/CellGrid.h"
+
+#include <utility>
+
+namespace {
+
+using Word = CellGrid::Word;
+
+// Bits of the last word of a line that belong to the line
+Word tail_mask(size_t length) {
+    const size_t used = length % CellGrid::kWordBits;
+    return used == 0 ? ~Word{0} : (Word{1} << used) - 1;
+}
+
+// Unknown cells in one line of words, filled and empty are both words long
+size_t count_unknown(const Word *filled, const Word *empty, size_t words, size_t length) {
+    size_t unknown = 0;
+    for (size_t w = 0; w < words; ++w) {
+        Word open = ~(filled[w] | empty[w]);
+        if (w + 1 == words)
+            open &= tail_mask(length);
+        unknown += static_cast<size_t>(__builtin_popcountll(open));
+    }
+    return unknown;
+}
+
+// In place 64x64 bit matrix transpose, bit c of word r ends up as bit r of word c.
+// Swaps ever smaller off-diagonal blocks: 32x32, then 16x16 within those, down to single bits.
+void transpose64(Word a[64]) {
+    Word mask = 0x00000000FFFFFFFFull;
+    for (size_t j = 32; j != 0; j >>= 1, mask ^= mask << j) {
+        for (size_t k = 0; k < 64; k = (k + j + 1) & ~j) {
+            const Word t = ((a[k] >> j) ^ a[k + j]) & mask;
+            a[k] ^= t << j;
+            a[k + j] ^= t;
+        }
+    }
+}
+
+// Fills the column-major plane cols from the row-major plane rows, one 64x64 block at a time
+void transpose_plane(const std::vector<Word> &rows, std::vector<Word> &cols, size_t row_count, size_t col_count,
+                     size_t row_words, size_t col_words) {
+    Word block[64];
+    for (size_t rb = 0; rb < col_words; ++rb) {
+        for (size_t cb = 0; cb < row_words; ++cb) {
+            for (size_t i = 0; i < 64; ++i) {
+                const size_t r = rb * 64 + i;
+                block[i] = r < row_count ? rows[r * row_words + cb] : 0;
+            }
+            transpose64(block);
+            for (size_t j = 0; j < 64 && cb * 64 + j < col_count; ++j)
+                cols[(cb * 64 + j) * col_words + rb] = block[j];
+        }
+    }
+}
+
+} // namespace
+
+void CellGrid::assign_rows(size_t rows, size_t cols, std::vector<Word> filled, std::vector<Word> empty) {
+    assign(0, 0);
+    rows_ = rows;
+    cols_ = cols;
+    row_words_ = (cols + kWordBits - 1) / kWordBits;
+    col_words_ = (rows + kWordBits - 1) / kWordBits;
+    row_filled_ = std::move(filled);
+    row_empty_ = std::move(empty);
+    row_filled_.resize(rows * row_words_, 0);
+    row_empty_.resize(rows * row_words_, 0);
+    col_filled_.assign(cols * col_words_, 0);
+    col_empty_.assign(cols * col_words_, 0);
+    transpose_plane(row_filled_, col_filled_, rows, cols, row_words_, col_words_);
+    transpose_plane(row_empty_, col_empty_, rows, cols, row_words_, col_words_);
+}
+
+void CellGrid::assign(size_t rows, size_t cols) {
+    rows_ = rows;
+    cols_ = cols;
+    row_words_ = (cols + kWordBits - 1) / kWordBits;
+    col_words_ = (rows + kWordBits - 1) / kWordBits;
+    row_filled_.assign(rows * row_words_, 0);
+    row_empty_.assign(rows * row_words_, 0);
+    col_filled_.assign(cols * col_words_, 0);
+    col_empty_.assign(cols * col_words_, 0);
+}
+
+size_t CellGrid::unknown_count() const {
+    size_t unknown = 0;
+    for (size_t r = 0; r < rows_; ++r)
+        unknown += unknown_in_row(r);
+    return unknown;
+}
+
+size_t CellGrid::unknown_in_row(size_t r) const {
+    return count_unknown(row_filled(r), row_empty(r), row_words_, cols_);
+}
+
+size_t CellGrid::unknown_in_col(size_t c) const {
+    return count_unknown(col_filled(c), col_empty(c), col_words_, rows_);
+}
+
+size_t CellGrid::next_unknown(size_t from) const {
+    const size_t total = rows_ * cols_;
+    if (cols_ == 0)
+        return total;
+
+    for (size_t r = from / cols_; r < rows_; ++r) {
+        const Word *filled = row_filled(r);
+        const Word *empty = row_empty(r);
+        const size_t start = r == from / cols_ ? from % cols_ : 0;
+        for (size_t w = start / kWordBits; w < row_words_; ++w) {
+            Word open = ~(filled[w] | empty[w]);
+            if (w + 1 == row_words_)
+                open &= tail_mask(cols_);
+            if (w == start / kWordBits)
+                open &= ~Word{0} << (start % kWordBits);
+            if (open != 0)
+                return r * cols_ + w * kWordBits + static_cast<size_t>(__builtin_ctzll(open));
+        }
+    }
+    return total;
+}
+
+void CellGrid::swap(CellGrid &other) noexcept {
+    std::swap(rows_, other.rows_);
+    std::swap(cols_, other.cols_);
+    std::swap(row_words_, other.row_words_);
+    std::swap(col_words_, other.col_words_);
+    row_filled_.swap(other.row_filled_);
+    row_empty_.swap(other.row_empty_);
+    col_filled_.swap(other.col_filled_);
+    col_empty_.swap(other.col_empty_);
+}
+
+// the column planes only mirror the row planes, comparing those is enough
+bool CellGrid::operator==(const CellGrid &other) const {
+    return rows_ == other.rows_ && cols_ == other.cols_ && row_filled_ == other.row_filled_ &&
+           row_empty_ == other.row_empty_;
+}
@@ -6,4 +6,4 @@ size_t Nonogram::rows() const { return row_clues.size(); }
 size_t Nonogram::cols() const { return col_clues.size(); }
 
 // resize cells to a grid of Unknown as per the cell enum
-void Nonogram::resize_from_clues() { cells.assign(rows(), std::vector<Cell>(cols(), Cell::Unknown)); }
+void Nonogram::resize_from_clues() { cells.assign(rows(), cols()); }
@@ -0,0 +1,410 @@
+#include "../include/NonogramBatch.h"
+#include "../include/NonogramBinarySource.h"
+#include "../include/NonogramSource.h"
+#include "../include/NonogramStreamSource.h"
+#include "../include/NonogramVerifier.h"
+#include "../include/core/BoundedQueue.h"
+#include "../include/core/ThreadPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+namespace {
+
+// Verify and SolveAndCheck compare against the grid in the puzzle file, the other modes don't read it
+bool reads_grid(BatchMode mode) {
+    return mode == BatchMode::Verify || mode == BatchMode::SolveAndCheck;
+}
+
+// Statuses where the puzzle holds a solution: solved, mismatch (solved to another grid), unique and multiple
+bool has_solution(const BatchResult &result) {
+    return result.status == "solved" || result.status == "mismatch" || result.status == "unique" ||
+           result.status == "multiple";
+}
+
+// .ngb files are BinaryFormat, everything else the text format
+bool is_binary_path(const std::string &path) {
+    return std::filesystem::path(path).extension() == ".ngb";
+}
+
+// "row r, column c" of the first cell that differs, both grids the same size
+std::string first_difference(const CellGrid &a, const CellGrid &b) {
+    for (size_t r = 0; r < a.rows(); ++r)
+        for (size_t c = 0; c < a.cols(); ++c)
+            if (a.get(r, c) != b.get(r, c))
+                return "row " + std::to_string(r + 1) + ", column " + std::to_string(c + 1);
+    return "no cell";
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+// CSV field, quoted only when it has to be
+std::string csv_field(const std::string &s) {
+    if (s.find_first_of(",\"\r\n") == std::string::npos)
+        return s;
+    std::string quoted = "\"";
+    for (const char ch : s) {
+        if (ch == '"')
+            quoted += '"';
+        quoted += ch;
+    }
+    return quoted + "\"";
+}
+
+std::string json_string(const std::string &s) {
+    static const char *hex = "0123456789abcdef";
+    std::string escaped = "\"";
+    for (const char ch : s) {
+        switch (ch) {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        case '\r':
+            escaped += "\\r";
+            break;
+        case '\t':
+            escaped += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                escaped += "\\u00";
+                escaped += hex[(ch >> 4) & 0xF];
+                escaped += hex[ch & 0xF];
+            } else {
+                escaped += ch;
+            }
+        }
+    }
+    return escaped + "\"";
+}
+
+} // namespace
+
+const char *batch_mode_name(BatchMode mode) {
+    switch (mode) {
+    case BatchMode::Solve:
+        return "solve";
+    case BatchMode::Verify:
+        return "verify";
+    case BatchMode::SolveAndCheck:
+        return "check";
+    case BatchMode::Unique:
+        return "unique";
+    default:
+        return "unknown";
+    }
+}
+
+NonogramBatch::NonogramBatch(BatchOptions options) : options_(options) {
+    options_.threads = std::max(1, options_.threads);
+    options_.solution_limit = std::max(1, options_.solution_limit);
+    if (!options_.cache_dir.empty() && options_.mode != BatchMode::Verify)
+        cache_ = std::make_unique<SolutionCache>(options_.cache_dir, options_.cache_max_bytes);
+}
+
+bool NonogramBatch::add(const std::string &path, std::string &out_error) {
+    namespace fs = std::filesystem;
+    out_error.clear();
+
+    std::error_code ec;
+    if (fs::is_directory(path, ec)) {
+        std::vector<std::string> files;
+        for (const auto &entry : fs::directory_iterator(path, ec)) {
+            if (entry.is_regular_file(ec) && (entry.path().extension() == ".txt" || entry.path().extension() == ".ngb"))
+                files.push_back(entry.path().string());
+        }
+        if (ec) {
+            out_error = "Failed to list directory: " + path;
+            return false;
+        }
+        // directory order is up to the file system, sort so runs are repeatable
+        std::sort(files.begin(), files.end());
+        paths_.insert(paths_.end(), files.begin(), files.end());
+        return true;
+    }
+
+    if (!fs::exists(path, ec)) {
+        out_error = "No such file or directory: " + path;
+        return false;
+    }
+    paths_.push_back(path);
+    return true;
+}
+
+BatchResult NonogramBatch::solve_one(const std::string &path, bool keep_solution) const {
+    BatchResult result;
+    result.path = path;
+
+    Nonogram puzzle;
+    CellGrid grid;
+    CellGrid *want_grid = reads_grid(options_.mode) ? &grid : nullptr;
+    const auto t0 = std::chrono::steady_clock::now();
+    bool read_ok = false;
+    if (!is_binary_path(path))
+        read_ok = NonogramSource(path).read(puzzle, result.error, want_grid);
+    else if (want_grid)
+        result.error = "Binary puzzle files have no grid.";
+    else
+        read_ok = NonogramBinarySource(path).read(puzzle, result.error);
+    const auto t1 = std::chrono::steady_clock::now();
+    result.parse_ms = elapsed_ms(t0, t1);
+    if (!read_ok) {
+        result.status = "read_error";
+        return result;
+    }
+    solve_puzzle(puzzle, grid, result);
+    if (keep_solution && has_solution(result))
+        result.solution = std::move(puzzle);
+    return result;
+}
+
+void NonogramBatch::solve_puzzle(Nonogram &puzzle, const CellGrid &grid, BatchResult &result) const {
+    const auto t0 = std::chrono::steady_clock::now();
+    if (options_.mode == BatchMode::Verify) {
+        result.status = verify_grid(puzzle, grid, result.error) ? "verified" : "wrong";
+        result.solve_ms = elapsed_ms(t0, std::chrono::steady_clock::now());
+        return;
+    }
+
+    NonogramSolver solver;
+    SolveLimits limits;
+    limits.timeout_ms = options_.timeout_ms;
+    solver.setLimits(limits);
+    apply_solver_options(solver, options_.solver);
+    if (options_.mode == BatchMode::Unique) {
+        count_solutions(solver, puzzle, result);
+        result.solve_ms = elapsed_ms(t0, std::chrono::steady_clock::now());
+        return;
+    }
+    solver.setCache(cache_.get());
+    const bool solved = solver.solve(puzzle, result.error);
+    result.solve_ms = elapsed_ms(t0, std::chrono::steady_clock::now());
+    result.status = solve_status_name(solver.status());
+    result.nodes = solver.searchNodes();
+    result.line_propagations = solver.linePropagations();
+    result.cached = solver.stats().cache_hits > 0;
+
+    // a puzzle with more than one solution can be solved to another grid, the note says if the file's grid is valid
+    if (solved && options_.mode == BatchMode::SolveAndCheck && puzzle.cells != grid) {
+        result.status = "mismatch";
+        result.error = "Solution differs from the grid in the file at " + first_difference(puzzle.cells, grid);
+        std::string grid_error;
+        if (!verify_grid(puzzle, grid, grid_error))
+            result.error += ", the file's grid is wrong: " + grid_error;
+        else
+            result.error += ", the file's grid is another solution";
+    }
+}
+
+void NonogramBatch::count_solutions(NonogramSolver &solver, Nonogram &puzzle, BatchResult &result) const {
+    SolutionCount count;
+    const bool ok = solver.countSolutions(puzzle, options_.solution_limit, count, result.error);
+    result.nodes = solver.searchNodes();
+    result.line_propagations = solver.linePropagations();
+    result.solutions = count.solutions;
+    result.exhausted = count.exhausted;
+    if (!count.distinguishing_cells.empty())
+        result.distinguishing_cell = count.distinguishing_cells.front();
+
+    // two solutions settle it even when a limit stopped the search right after
+    if (count.solutions >= 2)
+        result.status = "multiple";
+    else if (solver.status() == SolveStatus::TimedOut)
+        result.status = solve_status_name(SolveStatus::TimedOut);
+    else if (!ok || count.solutions == 0)
+        result.status = solve_status_name(SolveStatus::NoSolution);
+    else
+        result.status = count.exhausted ? "unique" : solve_status_name(SolveStatus::Solved);
+}
+
+void NonogramBatch::print_solution(NonogramPrinter &printer, const BatchResult &result, std::ostream *grids) const {
+    if (!grids || !has_solution(result))
+        return;
+    std::string error;
+    printer.print(result.solution, *grids, error);
+    // styled grids have no header, an empty line keeps them apart
+    if (options_.print_format == PrintFormat::Styled)
+        *grids << '\n';
+}
+
+void NonogramBatch::run(std::ostream &out, std::ostream *grids) const {
+    write_batch_header(out, options_.format, options_.mode);
+
+    std::vector<BatchResult> results(paths_.size());
+    std::vector<char> done(paths_.size(), 0);
+    std::mutex out_mutex;
+    size_t next_to_write = 0;
+    NonogramPrinter printer(options_.print_style);
+    printer.setFormat(options_.print_format);
+
+    nonogram::core::ThreadPool pool(options_.threads);
+    pool.run(paths_.size(), [&](int, size_t i) {
+        BatchResult result = solve_one(paths_[i], grids != nullptr);
+
+        // Records go out in input order, whoever finishes the next one in line writes the run that follows it
+        std::lock_guard<std::mutex> lock(out_mutex);
+        results[i] = std::move(result);
+        done[i] = 1;
+        while (next_to_write < paths_.size() && done[next_to_write]) {
+            write_batch_result(out, results[next_to_write], options_.format, options_.mode);
+            print_solution(printer, results[next_to_write], grids);
+            results[next_to_write] = BatchResult{};
+            ++next_to_write;
+        }
+    });
+    out.flush();
+}
+
+std::size_t NonogramBatch::run_stream(std::istream &in, const std::string &label, std::ostream &out,
+                                      std::ostream *grids) const {
+    struct Job {
+        size_t index = 0;
+        bool read_ok = false;
+        Nonogram puzzle;
+        CellGrid grid;
+        BatchResult result;
+    };
+    const size_t depth = options_.queue_depth > 0 ? options_.queue_depth : 2 * static_cast<size_t>(options_.threads);
+
+    write_batch_header(out, options_.format, options_.mode);
+
+    // parse stage
+    nonogram::core::BoundedQueue<Job> jobs(depth);
+    std::thread reader([&] {
+        NonogramStreamSource source(in, label);
+        for (size_t i = 0; !source.at_end(); ++i) {
+            Job job;
+            job.index = i;
+            const auto t0 = std::chrono::steady_clock::now();
+            job.read_ok = source.read(job.puzzle, job.result.error, reads_grid(options_.mode) ? &job.grid : nullptr);
+            job.result.parse_ms = elapsed_ms(t0, std::chrono::steady_clock::now());
+            job.result.path = source.name();
+            if (!job.read_ok)
+                job.result.status = "read_error";
+            if (!jobs.push(std::move(job)))
+                break;
+        }
+        jobs.close();
+    });
+
+    // Finished records wait here for the ones before them. A worker more than depth records ahead of the
+    // writer waits too, the one holding the next record never does, so this can't deadlock.
+    std::mutex m;
+    std::condition_variable changed;
+    std::map<size_t, BatchResult> finished;
+    size_t next_to_write = 0;
+    int solving = options_.threads;
+
+    std::vector<std::thread> solvers;
+    for (int t = 0; t < options_.threads; ++t) {
+        solvers.emplace_back([&] {
+            Job job;
+            while (jobs.pop(job)) {
+                if (job.read_ok)
+                    solve_puzzle(job.puzzle, job.grid, job.result);
+                if (grids && has_solution(job.result))
+                    job.result.solution = std::move(job.puzzle);
+                job.puzzle = Nonogram{};
+                job.grid = CellGrid{};
+
+                std::unique_lock<std::mutex> lock(m);
+                changed.wait(lock, [&] { return job.index < next_to_write + depth; });
+                finished.emplace(job.index, std::move(job.result));
+                changed.notify_all();
+            }
+            std::lock_guard<std::mutex> lock(m);
+            --solving;
+            changed.notify_all();
+        });
+    }
+
+    // write stage, records leave in stream order
+    NonogramPrinter printer(options_.print_style);
+    printer.setFormat(options_.print_format);
+    for (;;) {
+        BatchResult result;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            changed.wait(lock, [&] { return solving == 0 || (!finished.empty() && finished.begin()->first == next_to_write); });
+            if (finished.empty())
+                break;
+            result = std::move(finished.begin()->second);
+            finished.erase(finished.begin());
+            ++next_to_write;
+            changed.notify_all();
+        }
+        write_batch_result(out, result, options_.format, options_.mode);
+        print_solution(printer, result, grids);
+    }
+    out.flush();
+
+    reader.join();
+    for (auto &solver : solvers)
+        solver.join();
+    return next_to_write;
+}
+
+void write_batch_header(std::ostream &out, BatchFormat format, BatchMode mode) {
+    if (format != BatchFormat::Csv)
+        return;
+    out << "path,status,parse_ms,solve_ms,nodes,line_propagations,cached,";
+    if (mode == BatchMode::Unique)
+        out << "solutions,exhausted,diff_row,diff_col,";
+    out << "error\n";
+}
+
+void write_batch_result(std::ostream &out, const BatchResult &result, BatchFormat format, BatchMode mode) {
+    const bool unique = mode == BatchMode::Unique;
+    const bool has_cell = result.distinguishing_cell.first >= 0;
+    if (format == BatchFormat::Csv) {
+        out << csv_field(result.path) << ',' << result.status << ','
+            << result.parse_ms << ',' << result.solve_ms << ','
+            << result.nodes << ',' << result.line_propagations << ','
+            << (result.cached ? 1 : 0) << ',';
+        if (unique) {
+            out << result.solutions << ',' << (result.exhausted ? 1 : 0) << ',';
+            if (has_cell)
+                out << result.distinguishing_cell.first + 1 << ',' << result.distinguishing_cell.second + 1;
+            else
+                out << ',';
+            out << ',';
+        }
+        out << csv_field(result.error) << '\n';
+        return;
+    }
+
+    out << "{\"path\":" << json_string(result.path)
+        << ",\"status\":" << json_string(result.status)
+        << ",\"parse_ms\":" << result.parse_ms
+        << ",\"solve_ms\":" << result.solve_ms
+        << ",\"nodes\":" << result.nodes
+        << ",\"line_propagations\":" << result.line_propagations
+        << ",\"cached\":" << (result.cached ? "true" : "false");
+    if (unique) {
+        out << ",\"solutions\":" << result.solutions
+            << ",\"exhausted\":" << (result.exhausted ? "true" : "false")
+            << ",\"distinguishing_cell\":";
+        if (has_cell)
+            out << '[' << result.distinguishing_cell.first + 1 << ',' << result.distinguishing_cell.second + 1 << ']';
+        else
+            out << "null";
+    }
+    out << ",\"error\":" << json_string(result.error) << "}\n";
+}
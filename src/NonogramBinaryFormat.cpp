@@ -0,0 +1,174 @@
+#include "../include/NonogramBinaryFormat.h"
+
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace {
+
+bool fail(std::string &out_error, const char *msg) {
+    out_error = msg;
+    return false;
+}
+
+void put_varint(std::string &out, std::uint32_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+// Decodes from data at pos, false if the data ends inside the varint, it doesn't fit 32 bits
+// or it has padding zero bytes (so a puzzle has exactly one encoding)
+bool get_varint(std::string_view data, size_t &pos, std::uint32_t &out_value) {
+    // nearly every clue and count fits one byte
+    if (pos < data.size() && !(data[pos] & 0x80)) {
+        out_value = static_cast<unsigned char>(data[pos++]);
+        return true;
+    }
+
+    std::uint64_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= data.size())
+            return false;
+        const auto byte = static_cast<unsigned char>(data[pos++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if (byte & 0x80)
+            continue;
+        if (byte == 0 || value > 0xFFFFFFFFu)
+            return false;
+        out_value = static_cast<std::uint32_t>(value);
+        return true;
+    }
+    return false;
+}
+
+// Line lengths of one section into offsets (CSR, lines + 1 entries), false unless they add up to total
+bool read_offsets(std::string_view data, size_t &pos, size_t lines, std::uint32_t total,
+                  std::vector<std::uint32_t> &offsets) {
+    offsets.resize(lines + 1);
+    offsets[0] = 0;
+    std::uint64_t sum = 0;
+    for (size_t i = 0; i < lines; ++i) {
+        std::uint32_t count = 0;
+        if (!get_varint(data, pos, count))
+            return false;
+        sum += count;
+        if (sum > total)
+            return false;
+        offsets[i + 1] = static_cast<std::uint32_t>(sum);
+    }
+    return sum == total;
+}
+
+void append_section(std::string &out, const std::vector<std::vector<int>> &lines, bool runs) {
+    for (const auto &clues : lines) {
+        if (!runs) {
+            put_varint(out, static_cast<std::uint32_t>(clues.size()));
+            continue;
+        }
+        for (const int clue : clues)
+            put_varint(out, static_cast<std::uint32_t>(clue));
+    }
+}
+
+} // namespace
+
+namespace BinaryFormat {
+
+bool is_binary_format(std::string_view data) {
+    return data.size() >= sizeof(kMagic) && std::memcmp(data.data(), kMagic, sizeof(kMagic)) == 0;
+}
+
+bool read_binary_format(std::string_view data, Nonogram &out_puzzle, std::string &out_error) {
+    out_error.clear();
+    out_puzzle = Nonogram{};
+
+    if (!is_binary_format(data))
+        return fail(out_error, "Not a binary puzzle file (bad magic).");
+    size_t pos = sizeof(kMagic);
+    if (pos >= data.size())
+        return fail(out_error, "Truncated binary puzzle file.");
+    if (static_cast<std::uint8_t>(data[pos++]) != kVersion)
+        return fail(out_error, "Unsupported binary puzzle version.");
+
+    std::uint32_t rows = 0, cols = 0, row_total = 0, col_total = 0;
+    if (!get_varint(data, pos, rows) || !get_varint(data, pos, cols) ||
+        !get_varint(data, pos, row_total) || !get_varint(data, pos, col_total))
+        return fail(out_error, "Truncated binary puzzle file.");
+    if (rows == 0 || cols == 0)
+        return fail(out_error, "Expected positive non-zero values for rows and cols.");
+
+    // every count and run takes at least a byte, so sizes past that are corrupt rather than big
+    const std::uint64_t least_bytes = std::uint64_t{rows} + cols + row_total + col_total;
+    if (least_bytes > data.size() - pos)
+        return fail(out_error, "Truncated binary puzzle file.");
+
+    // CSR offsets of both sections
+    std::vector<std::uint32_t> row_offsets, col_offsets;
+    if (!read_offsets(data, pos, rows, row_total, row_offsets) ||
+        !read_offsets(data, pos, cols, col_total, col_offsets))
+        return fail(out_error, "Clue counts don't match the clue totals.");
+
+    // runs go straight into the clue lists, the offsets size each list up front
+    auto read_runs = [&](const std::vector<std::uint32_t> &offsets, std::vector<std::vector<int>> &out_lines) {
+        out_lines.resize(offsets.size() - 1);
+        for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+            out_lines[i].resize(offsets[i + 1] - offsets[i]);
+            for (int &run : out_lines[i]) {
+                std::uint32_t value = 0;
+                if (!get_varint(data, pos, value))
+                    return fail(out_error, "Truncated binary puzzle file.");
+                if (value == 0 || value > static_cast<std::uint32_t>(std::numeric_limits<int>::max()))
+                    return fail(out_error, "Clue run out of range.");
+                run = static_cast<int>(value);
+            }
+        }
+        return true;
+    };
+    if (!read_runs(row_offsets, out_puzzle.row_clues) || !read_runs(col_offsets, out_puzzle.col_clues)) {
+        out_puzzle = Nonogram{};
+        return false;
+    }
+    if (pos != data.size()) {
+        out_puzzle = Nonogram{};
+        return fail(out_error, "Unexpected data after the clues.");
+    }
+
+    out_puzzle.resize_from_clues();
+    return true;
+}
+
+std::string to_binary_format(const Nonogram &puzzle) {
+    std::uint32_t row_total = 0, col_total = 0;
+    for (const auto &clues : puzzle.row_clues)
+        row_total += static_cast<std::uint32_t>(clues.size());
+    for (const auto &clues : puzzle.col_clues)
+        col_total += static_cast<std::uint32_t>(clues.size());
+
+    std::string bytes(kMagic, sizeof(kMagic));
+    bytes += static_cast<char>(kVersion);
+    put_varint(bytes, static_cast<std::uint32_t>(puzzle.rows()));
+    put_varint(bytes, static_cast<std::uint32_t>(puzzle.cols()));
+    put_varint(bytes, row_total);
+    put_varint(bytes, col_total);
+    append_section(bytes, puzzle.row_clues, false);
+    append_section(bytes, puzzle.col_clues, false);
+    append_section(bytes, puzzle.row_clues, true);
+    append_section(bytes, puzzle.col_clues, true);
+    return bytes;
+}
+
+bool write_binary_format(std::ostream &out, const Nonogram &puzzle, std::string &out_error) {
+    out_error.clear();
+    const std::string bytes = to_binary_format(puzzle);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    out.flush();
+    if (!out)
+        return fail(out_error, "Failed to write puzzle");
+    return true;
+}
+
+} // namespace BinaryFormat
@@ -0,0 +1,29 @@
+#include "../include/NonogramBinarySource.h"
+#include "../include/NonogramBinaryFormat.h"
+
+#include <fstream>
+#include <utility>
+
+NonogramBinarySource::NonogramBinarySource(std::string path)
+    : path_(std::move(path)) {}
+
+bool NonogramBinarySource::read(Nonogram &out_puzzle, std::string &out_error) {
+    out_error.clear();
+    out_puzzle = Nonogram{};
+
+    std::ifstream in(path_, std::ios::binary | std::ios::ate);
+    if (!in) {
+        out_error = "Failed to open file: " + path_;
+        return false;
+    }
+
+    const std::streamoff size = in.tellg();
+    std::string bytes(size > 0 ? static_cast<size_t>(size) : 0, '\0');
+    in.seekg(0);
+    if (!in.read(&bytes[0], static_cast<std::streamsize>(bytes.size()))) {
+        out_error = "Failed to read file: " + path_;
+        return false;
+    }
+
+    return BinaryFormat::read_binary_format(bytes, out_puzzle, out_error);
+}
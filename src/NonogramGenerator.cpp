@@ -0,0 +1,139 @@
+#include "../include/NonogramGenerator.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+// mt19937_64 output is fixed by the standard, the distributions aren't, so everything below works on raw draws
+
+bool draw_filled(std::mt19937_64 &rng, long double threshold) {
+    return static_cast<long double>(rng()) < threshold;
+}
+
+// Uniform enough in [0, n) for grid sizes, n must be positive
+int draw_below(std::mt19937_64 &rng, int n) {
+    return static_cast<int>(rng() % static_cast<std::uint64_t>(n));
+}
+
+void fill_random(CellGrid &grid, std::mt19937_64 &rng, long double threshold) {
+    for (size_t r = 0; r < grid.rows(); ++r)
+        for (size_t c = 0; c < grid.cols(); ++c)
+            if (draw_filled(rng, threshold))
+                grid.set(r, c, Cell::Filled);
+}
+
+void fill_symmetric(CellGrid &grid, std::mt19937_64 &rng, long double threshold) {
+    const size_t cols = grid.cols();
+    for (size_t r = 0; r < grid.rows(); ++r) {
+        for (size_t c = 0; c < (cols + 1) / 2; ++c) {
+            if (draw_filled(rng, threshold)) {
+                grid.set(r, c, Cell::Filled);
+                grid.set(r, cols - 1 - c, Cell::Filled);
+            }
+        }
+    }
+}
+
+// Drops rectangles of up to an eighth of the smaller side until the Filled share reaches density
+void fill_blocks(CellGrid &grid, std::mt19937_64 &rng, double density, int rows, int cols) {
+    const std::uint64_t total = static_cast<std::uint64_t>(rows) * static_cast<std::uint64_t>(cols);
+    const std::uint64_t target = static_cast<std::uint64_t>(density * static_cast<double>(total));
+    const int max_side = std::max(1, std::min(rows, cols) / 8);
+
+    std::uint64_t filled = 0;
+    while (filled < target) {
+        const int height = 1 + draw_below(rng, max_side);
+        const int width = 1 + draw_below(rng, max_side);
+        const int top = draw_below(rng, rows);
+        const int left = draw_below(rng, cols);
+        for (int r = top; r < std::min(rows, top + height); ++r) {
+            for (int c = left; c < std::min(cols, left + width); ++c) {
+                if (grid.get(r, c) != Cell::Filled) {
+                    grid.set(r, c, Cell::Filled);
+                    ++filled;
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+const char *generator_pattern_name(GeneratorPattern pattern) {
+    switch (pattern) {
+    case GeneratorPattern::Random:
+        return "random";
+    case GeneratorPattern::Blocks:
+        return "blocks";
+    case GeneratorPattern::Symmetric:
+        return "symmetric";
+    default:
+        return "unknown";
+    }
+}
+
+std::vector<int> clues_from_line(const std::vector<Cell> &line) {
+    std::vector<int> clues;
+    int run = 0;
+    for (const Cell cell : line) {
+        if (cell == Cell::Filled) {
+            ++run;
+        } else if (run > 0) {
+            clues.push_back(run);
+            run = 0;
+        }
+    }
+    if (run > 0)
+        clues.push_back(run);
+    return clues;
+}
+
+Nonogram generate_random_puzzle(const GeneratorOptions &options, CellGrid *out_solution) {
+    std::mt19937_64 rng(options.seed);
+    const double density = options.density < 0.0 ? 0.0 : options.density > 1.0 ? 1.0 : options.density;
+    const long double threshold = static_cast<long double>(density) * 18446744073709551616.0L; // 2^64
+
+    const int rows = std::max(0, options.rows);
+    const int cols = std::max(0, options.cols);
+    CellGrid grid(rows, cols);
+    for (int r = 0; r < rows; ++r)
+        for (int c = 0; c < cols; ++c)
+            grid.set(r, c, Cell::Empty);
+    switch (options.pattern) {
+    case GeneratorPattern::Blocks:
+        if (rows > 0 && cols > 0)
+            fill_blocks(grid, rng, density, rows, cols);
+        break;
+    case GeneratorPattern::Symmetric:
+        fill_symmetric(grid, rng, threshold);
+        break;
+    default:
+        fill_random(grid, rng, threshold);
+        break;
+    }
+
+    Nonogram puzzle;
+    puzzle.row_clues.reserve(rows);
+    std::vector<Cell> line(cols);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c)
+            line[c] = grid.get(r, c);
+        puzzle.row_clues.push_back(clues_from_line(line));
+    }
+
+    puzzle.col_clues.reserve(cols);
+    line.resize(rows);
+    for (int c = 0; c < cols; ++c) {
+        for (int r = 0; r < rows; ++r)
+            line[r] = grid.get(r, c);
+        puzzle.col_clues.push_back(clues_from_line(line));
+    }
+
+    puzzle.resize_from_clues();
+    if (out_solution)
+        out_solution->swap(grid);
+    return puzzle;
+}
@@ -1,28 +1,183 @@
 #include "../include/NonogramPrinter.h"
+#include "../include/NonogramTextFormat.h"
+#include "../include/core/FdStreamBuf.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+namespace {
+
+using Word = CellGrid::Word;
+
+// rows are rendered into the buffer until it holds about this much, then written in one go
+constexpr size_t kFlushBytes = size_t{1} << 16;
+
+void append_number(std::string &out, size_t value) {
+    char digits[20];
+    size_t n = 0;
+    do {
+        digits[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (n > 0)
+        out += digits[--n];
+}
+
+// PBM puts the leftmost cell in the high bit of a byte, CellGrid in the low bit
+const std::array<unsigned char, 256> &reversed_bits() {
+    static const std::array<unsigned char, 256> table = [] {
+        std::array<unsigned char, 256> t{};
+        for (int b = 0; b < 256; ++b)
+            for (int i = 0; i < 8; ++i)
+                if (b & (1 << i))
+                    t[b] |= static_cast<unsigned char>(0x80 >> i);
+        return t;
+    }();
+    return table;
+}
+
+// Bits set where the cells of word w have the state cell
+Word state_bits(const Word *filled, const Word *empty, size_t w, Cell cell) {
+    if (cell == Cell::Filled)
+        return filled[w];
+    if (cell == Cell::Empty)
+        return empty[w];
+    return ~(filled[w] | empty[w]);
+}
+
+// End of the run of cell starting at from, a word at a time
+size_t run_end(const Word *filled, const Word *empty, Cell cell, size_t from, size_t length) {
+    size_t w = from / CellGrid::kWordBits;
+    Word other = ~state_bits(filled, empty, w, cell) & (~Word{0} << (from % CellGrid::kWordBits));
+    const size_t words = (length + CellGrid::kWordBits - 1) / CellGrid::kWordBits;
+    while (other == 0 && ++w < words)
+        other = ~state_bits(filled, empty, w, cell);
+    if (other == 0)
+        return length;
+    return std::min(length, w * CellGrid::kWordBits + static_cast<size_t>(__builtin_ctzll(other)));
+}
+
+} // namespace
+
+const char *print_format_name(PrintFormat format) {
+    switch (format) {
+    case PrintFormat::Styled:
+        return "styled";
+    case PrintFormat::Bits:
+        return "bits";
+    case PrintFormat::RunLength:
+        return "rle";
+    case PrintFormat::Text:
+        return "text";
+    default:
+        return "unknown";
+    }
+}
 
 void NonogramPrinter::setStyle(PrintStyle style) {
     this->style = style;
 }
 
+void NonogramPrinter::setFormat(PrintFormat format) {
+    this->format = format;
+}
+
 NonogramPrinter::NonogramPrinter() : NonogramPrinter(PrintStyle{}) {}
 NonogramPrinter::NonogramPrinter(PrintStyle style) : style(style) {}
 
-void NonogramPrinter::printCell(Cell cell) {
-    if (cell == Cell::Filled)
-        std::cout << style.filled << style.cellSpace;
-    else if (cell == Cell::Empty)
-        std::cout << style.empty << style.cellSpace;
-    else
-        std::cout << style.unknown << style.cellSpace;
+bool NonogramPrinter::flush(std::ostream &out, bool force) {
+    if (buffer.size() < kFlushBytes && !force)
+        return true;
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    buffer.clear();
+    return static_cast<bool>(out);
+}
+
+void NonogramPrinter::printRow(const CellGrid &cells, size_t row) {
+    // one piece of text per state, indexed by the filled bit plus twice the empty bit
+    const std::string text[3] = {style.unknown + style.cellSpace, style.filled + style.cellSpace,
+                                 style.empty + style.cellSpace};
+    const Word *filled = cells.row_filled(row);
+    const Word *empty = cells.row_empty(row);
+    for (size_t w = 0; w < cells.row_words(); ++w) {
+        const size_t count = std::min(CellGrid::kWordBits, cells.cols() - w * CellGrid::kWordBits);
+        for (size_t bit = 0; bit < count; ++bit)
+            buffer += text[((filled[w] >> bit) & 1) | (((empty[w] >> bit) & 1) << 1)];
+    }
+    buffer += style.rowSpace;
+}
+
+void NonogramPrinter::printBitsRow(const CellGrid &cells, size_t row) {
+    const auto &reversed = reversed_bits();
+    const Word *words = cells.row_filled(row);
+    for (size_t byte = 0; byte < (cells.cols() + 7) / 8; ++byte) {
+        const auto bits = static_cast<unsigned char>(words[byte / 8] >> (8 * (byte % 8)));
+        buffer += static_cast<char>(reversed[bits]);
+    }
+}
+
+void NonogramPrinter::printRunLengthRow(const CellGrid &cells, size_t row) {
+    const Word *filled = cells.row_filled(row);
+    const Word *empty = cells.row_empty(row);
+    for (size_t col = 0; col < cells.cols();) {
+        const Cell cell = cells.get(row, col);
+        const size_t end = run_end(filled, empty, cell, col, cells.cols());
+        if (end - col > 1)
+            append_number(buffer, end - col);
+        buffer += cell == Cell::Filled ? '+' : cell == Cell::Empty ? '.' : '?';
+        col = end;
+    }
+    buffer += '\n';
+}
+
+bool NonogramPrinter::print(const Nonogram &puzzle, std::ostream &out, std::string &out_error) {
+    out_error.clear();
+    if (format == PrintFormat::Text)
+        return TextFormat::write_text_format(out, puzzle, out_error);
+
+    const CellGrid &cells = puzzle.cells;
+    buffer.clear();
+    if (format == PrintFormat::Bits) {
+        buffer += "P4\n";
+        append_number(buffer, cells.cols());
+        buffer += ' ';
+        append_number(buffer, cells.rows());
+        buffer += '\n';
+    } else if (format == PrintFormat::RunLength) {
+        append_number(buffer, cells.rows());
+        buffer += ' ';
+        append_number(buffer, cells.cols());
+        buffer += '\n';
+    }
+
+    bool ok = true;
+    for (size_t row = 0; row < cells.rows() && ok; ++row) {
+        if (format == PrintFormat::Bits)
+            printBitsRow(cells, row);
+        else if (format == PrintFormat::RunLength)
+            printRunLengthRow(cells, row);
+        else
+            printRow(cells, row);
+        ok = flush(out, false);
+    }
+    ok = ok && flush(out, true) && out.flush();
+    buffer.clear();
+    if (!ok) {
+        out_error = "Failed to write puzzle";
+        return false;
+    }
+    return true;
 }
 
-void NonogramPrinter::printRow(std::vector<Cell> &cells) {
-    for (auto &cell : cells)
-        printCell(cell);
-    std::cout << style.rowSpace;
+bool NonogramPrinter::print(const Nonogram &puzzle, int fd, std::string &out_error) {
+    nonogram::core::FdStreamBuf buf(fd);
+    std::ostream out(&buf);
+    return print(puzzle, out, out_error);
 }
 
 void NonogramPrinter::print(Nonogram &puzzle) {
-    for (auto &row : puzzle.cells)
-        printRow(row);
+    std::string error;
+    print(puzzle, std::cout, error);
 }
@@ -1,21 +1,21 @@
 #include "../include/NonogramSource.h"
 #include "../include/NonogramTextFormat.h"
+#include "../include/core/MappedFile.h"
 
-#include <fstream>
 #include <utility>
 
 NonogramSource::NonogramSource(std::string path)
     : path_(std::move(path)) {}
 
-bool NonogramSource::read(Nonogram &out_puzzle, std::string &out_error) const {
+bool NonogramSource::read(Nonogram &out_puzzle, std::string &out_error, CellGrid *out_grid) const {
     out_error.clear();
     out_puzzle = Nonogram{};
 
-    std::ifstream in(path_);
-    if (!in) {
+    nonogram::core::MappedFile file;
+    if (!file.open(path_)) {
         out_error = "Failed to open file: " + path_;
         return false;
     }
 
-    return TextFormat::read_text_format(in, out_puzzle, out_error);
+    return TextFormat::read_text_format(file.view(), out_puzzle, out_error, out_grid);
 }
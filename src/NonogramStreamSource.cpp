@@ -0,0 +1,182 @@
+#include "../include/NonogramStreamSource.h"
+#include "../include/NonogramBinaryFormat.h"
+#include "../include/NonogramTextFormat.h"
+#include "../include/core/TextFormatParseUtil.h"
+
+#include <algorithm>
+#include <istream>
+#include <string_view>
+#include <utility>
+
+using namespace nonogram::io::textformat;
+
+namespace {
+
+constexpr std::string_view kFrameTag = "@puzzle";
+
+bool is_frame_line(std::string_view line) {
+    return line.substr(0, kFrameTag.size()) == kFrameTag;
+}
+
+// "R C" and nothing else, the first line of a text puzzle
+bool is_header_line(std::string_view line, int &out_rows) {
+    size_t pos = 0;
+    int rows = 0, cols = 0;
+    if (!scan_int(line, pos, rows) || !scan_int(line, pos, cols) || !trim(line.substr(pos)).empty())
+        return false;
+    out_rows = rows;
+    return true;
+}
+
+bool starts_puzzle(std::string_view line) {
+    int rows = 0;
+    return is_frame_line(line) || is_header_line(line, rows);
+}
+
+bool is_digit(char ch) {
+    return ch >= '0' && ch <= '9';
+}
+
+// `cat` of files without a newline at the end glues the next puzzle's "R C" header onto the last row line.
+// Grid cells are only + and ., so two numbers at the end of a row line's grid part can only be that header.
+// Returns where the header starts, npos if the line has none.
+size_t glued_header(std::string_view line) {
+    const size_t bar = line.rfind('|');
+    if (bar == std::string_view::npos)
+        return std::string_view::npos;
+    size_t pos = line.size();
+    for (int number = 0; number < 2; ++number) {
+        while (pos > bar + 1 && is_space(line[pos - 1]))
+            --pos;
+        const size_t end = pos;
+        while (pos > bar + 1 && is_digit(line[pos - 1]))
+            --pos;
+        if (pos == end)
+            return std::string_view::npos;
+    }
+    int rows = 0;
+    return is_header_line(line.substr(pos), rows) ? pos : std::string_view::npos;
+}
+
+} // namespace
+
+NonogramStreamSource::NonogramStreamSource(std::istream &in, std::string label)
+    : in_(in), label_(std::move(label)) {}
+
+bool NonogramStreamSource::next_line(std::string &out_line) {
+    if (has_held_line_) {
+        out_line.swap(held_line_);
+        has_held_line_ = false;
+        return true;
+    }
+    return static_cast<bool>(std::getline(in_, out_line));
+}
+
+bool NonogramStreamSource::at_end() {
+    std::string line;
+    while (next_line(line)) {
+        if (!trim(line).empty()) {
+            held_line_.swap(line);
+            has_held_line_ = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool NonogramStreamSource::read(Nonogram &out_puzzle, std::string &out_error) {
+    return read(out_puzzle, out_error, nullptr);
+}
+
+bool NonogramStreamSource::read(Nonogram &out_puzzle, std::string &out_error, CellGrid *out_grid) {
+    out_error.clear();
+    out_puzzle = Nonogram{};
+
+    if (at_end())
+        return fail(out_error, "No puzzle left in the stream.");
+    ++count_;
+    name_ = label_ + "#" + std::to_string(count_);
+
+    std::string first;
+    next_line(first);
+    if (is_frame_line(trim(first))) {
+        std::string payload;
+        if (!read_frame(first, payload, out_error))
+            return false;
+        if (BinaryFormat::is_binary_format(payload)) {
+            if (out_grid)
+                return fail(out_error, "Binary puzzles have no grid.");
+            return BinaryFormat::read_binary_format(payload, out_puzzle, out_error);
+        }
+        return TextFormat::read_text_format(std::string_view(payload), out_puzzle, out_error, out_grid);
+    }
+
+    std::string text;
+    read_text_chunk(first, text);
+    return TextFormat::read_text_format(std::string_view(text), out_puzzle, out_error, out_grid);
+}
+
+bool NonogramStreamSource::read_frame(const std::string &header, std::string &out_payload, std::string &out_error) {
+    const std::string_view line = trim(header);
+    size_t pos = kFrameTag.size();
+    int bytes = 0;
+    if (!scan_int(line, pos, bytes) || bytes < 0)
+        return fail(out_error, "Expected a byte count after @puzzle.");
+    const std::string_view name = trim(line.substr(pos));
+    if (!name.empty())
+        name_ = std::string(name);
+
+    // read in steps, so a corrupt count can't allocate much more than the stream actually holds
+    constexpr size_t kStep = size_t{1} << 20;
+    const size_t size = static_cast<size_t>(bytes);
+    out_payload.clear();
+    while (out_payload.size() < size) {
+        const size_t have = out_payload.size();
+        const size_t step = std::min(kStep, size - have);
+        out_payload.resize(have + step);
+        if (!in_.read(&out_payload[have], static_cast<std::streamsize>(step)))
+            return fail(out_error, "Truncated puzzle frame.");
+    }
+    return true;
+}
+
+// The header, the column clue lines down to the separator, then `rows` row lines.
+// A line that starts another puzzle ends it early, the parser then says what's missing.
+void NonogramStreamSource::read_text_chunk(const std::string &first_line, std::string &out_text) {
+    out_text = first_line;
+    out_text += '\n';
+
+    // without a header there's no telling where it ends, everything up to the next puzzle is one bad puzzle
+    int rows = 0;
+    const bool has_header = is_header_line(trim(first_line), rows);
+    bool past_separator = false;
+    int rows_left = rows;
+
+    std::string line;
+    while ((!has_header || !past_separator || rows_left > 0) && next_line(line)) {
+        const std::string_view trimmed = trim(line);
+        if (starts_puzzle(trimmed)) {
+            held_line_.swap(line);
+            has_held_line_ = true;
+            break;
+        }
+        if (has_header && past_separator) {
+            const size_t header = glued_header(line);
+            if (header != std::string_view::npos) {
+                held_line_ = line.substr(header);
+                has_held_line_ = true;
+                out_text.append(line, 0, header);
+                out_text += '\n';
+                break;
+            }
+        }
+        out_text += line;
+        out_text += '\n';
+        if (!has_header || trimmed.empty())
+            continue;
+        if (past_separator)
+            --rows_left;
+        else
+            past_separator = is_separator_line(trimmed);
+    }
+}
@@ -8,6 +8,8 @@
 #include <algorithm>
 #include <cctype>
 #include <istream>
+#include <iterator>
+#include <ostream>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -34,71 +36,112 @@ bool consume_clue_token(std::string &out_error, std::string_view token,
 }
 
 // I could probably extract the common stuff from both of these under me. maybe use a lambda again. I cba, I want a proper solver
-bool consume_column_clue_line(std::string &out_error, const std::vector<std::string> &right_tokens,
+bool consume_column_clue_line(std::string &out_error, std::string_view right,
                               std::vector<std::vector<int>> &col_clues, std::size_t line_i, std::string_view line_text) {
-    if (right_tokens.size() != col_clues.size())
+    const size_t token_count = count_tokens(right);
+    if (token_count != col_clues.size())
         return fail(out_error, with_line(wrong_column_token_count(
-                                             right_tokens.size(), col_clues.size()),
+                                             token_count, col_clues.size()),
                                          line_i, line_text));
 
+    size_t pos = 0;
     for (size_t col = 0; col < col_clues.size(); col++)
-        if (!consume_clue_token(out_error, right_tokens[col], col_clues[col], line_i, line_text))
+        if (!consume_clue_token(out_error, next_token(right, pos), col_clues[col], line_i, line_text))
             return false;
     return true;
 }
 
-bool consume_row_clue_line(std::string &out_error, const std::vector<std::string> &tokens,
+bool consume_row_clue_line(std::string &out_error, std::string_view left,
                            std::vector<int> &out_clues, size_t line_index, std::string_view line_text) {
-    for (const auto &tok : tokens)
+    size_t pos = 0;
+    for (auto tok = next_token(left, pos); !tok.empty(); tok = next_token(left, pos))
         if (!consume_clue_token(out_error, tok, out_clues, line_index, line_text))
             return false;
     return true;
 }
 
-bool split_pipe_and_tokenise(std::string &out_error,
-                             const std::vector<std::string> &lines,
-                             std::size_t line_index,
-                             std::vector<std::string> &out_left_tokens,
-                             std::vector<std::string> &out_right_tokens,
-                             bool is_column_section) {
-    std::string left, right;
-    if (!split_pipe(lines[line_index], left, right)) {
-        return fail(out_error, with_line(
-                                   is_column_section ? missing_pipe_column()
-                                                     : missing_pipe_row(),
-                                   line_index, lines[line_index]));
+// The grid half of a row line, exactly cols tokens of + or ., as bits into one row of CellGrid planes
+bool consume_grid_line(std::string &out_error, std::string_view right, size_t cols, CellGrid::Word *filled,
+                       CellGrid::Word *empty, size_t line_index, std::string_view line_text) {
+    // A char at a time rather than token by token, the grid is most of a big file.
+    // Nothing branches on + vs . (they come in no order) and each word is built in a register.
+    using Word = CellGrid::Word;
+    size_t c = 0;
+    Word filled_bits = 0, empty_bits = 0;
+    for (size_t pos = 0; pos < right.size(); ++pos) {
+        const char ch = right[pos];
+        if (is_space(ch))
+            continue;
+        const bool plus = ch == '+', dot = ch == '.';
+        const bool one_char = pos + 1 == right.size() || is_space(right[pos + 1]);
+        if (!one_char | !(plus | dot))
+            return fail(out_error, with_line(invalid_grid_cell(next_token(right, pos)), line_index, line_text));
+        if (c < cols) {
+            const size_t bit = c % CellGrid::kWordBits;
+            filled_bits |= Word{plus} << bit;
+            empty_bits |= Word{dot} << bit;
+            if (bit == CellGrid::kWordBits - 1 || c + 1 == cols) {
+                filled[c / CellGrid::kWordBits] = filled_bits;
+                empty[c / CellGrid::kWordBits] = empty_bits;
+                filled_bits = empty_bits = 0;
+            }
+        }
+        ++c;
     }
-
-    out_left_tokens = split_ws(left);
-    out_right_tokens = split_ws(right);
+    if (c != cols)
+        return fail(out_error, with_line(wrong_grid_cell_count(c, cols), line_index, line_text));
     return true;
 }
 
+// Splits each line at its '|' and hands both halves to handle_halves, halves are tokenised on demand
 template <class Fn>
-bool for_each_pipe_line(std::string &out_error, const std::vector<std::string> &lines,
-                        size_t begin, size_t end, bool is_column_section, Fn &&handle_tokens) {
+bool for_each_pipe_line(std::string &out_error, const std::vector<std::string_view> &lines,
+                        size_t begin, size_t end, bool is_column_section, Fn &&handle_halves) {
     for (size_t i = begin; i < end; i++) {
-        std::vector<std::string> left_tokens, right_tokens;
-
-        if (!split_pipe_and_tokenise(out_error, lines, i, left_tokens, right_tokens, is_column_section))
-            return false;
-        if (!handle_tokens(i, left_tokens, right_tokens))
+        std::string_view left, right;
+        if (!split_pipe(lines[i], left, right))
+            return fail(out_error, with_line(
+                                       is_column_section ? missing_pipe_column()
+                                                         : missing_pipe_row(),
+                                       i, lines[i]));
+        if (!handle_halves(i, left, right))
             return false;
     }
     return true;
 }
 
+// Appends token right-aligned in a field of width
+void append_field(std::string &line, const std::string &token, size_t width) {
+    if (token.size() < width)
+        line.append(width - token.size(), ' ');
+    line += token;
+}
+
+// Clue i of the n slots a line gets, clues sit against the '|' / separator with '.' padding before them
+std::string clue_slot(const std::vector<int> &clues, size_t slot, size_t slots) {
+    const size_t pad = slots - clues.size();
+    return slot < pad ? "." : std::to_string(clues[slot - pad]);
+}
+
 } // namespace
 
 namespace TextFormat {
 
+bool read_text_format(std::istream &in, Nonogram &out_puzzle, std::string &out_error, CellGrid *out_grid) {
+    const std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    return read_text_format(std::string_view(text), out_puzzle, out_error, out_grid);
+}
+
 // I wanted to shorten this method I just cba
-bool read_text_format(std::istream &in, Nonogram &out_puzzle, std::string &out_error) {
+bool read_text_format(std::string_view text, Nonogram &out_puzzle, std::string &out_error, CellGrid *out_grid) {
     out_error.clear();
     out_puzzle = Nonogram{};
+    if (out_grid)
+        *out_grid = CellGrid{};
 
+    size_t pos = 0;
     int row_size = 0, col_size = 0;
-    if (!(in >> row_size >> col_size))
+    if (!scan_int(text, pos, row_size) || !scan_int(text, pos, col_size))
         return fail(out_error, expected_rows_cols());
     if (row_size <= 0 || col_size <= 0)
         return fail(out_error, non_positive_dimensions());
@@ -107,13 +150,14 @@ bool read_text_format(std::istream &in, Nonogram &out_puzzle, std::string &out_e
     const size_t cols = static_cast<size_t>(col_size);
 
     // consume remainder of first line
-    std::string line;
-    std::getline(in, line);
+    pos = std::min(text.find('\n', pos), text.size());
 
-    // read remaining non-empty trimmed lines
-    std::vector<std::string> lines;
-    while (std::getline(in, line)) {
-        line = ::trim(line);
+    // remaining non-empty trimmed lines, as views into text
+    std::vector<std::string_view> lines;
+    while (pos < text.size()) {
+        const size_t begin = pos + 1;
+        pos = std::min(text.find('\n', begin), text.size());
+        const std::string_view line = ::trim(text.substr(begin, pos - begin));
         if (!line.empty())
             lines.push_back(line);
     }
@@ -135,7 +179,7 @@ bool read_text_format(std::istream &in, Nonogram &out_puzzle, std::string &out_e
     std::vector<std::vector<int>> col_clues(cols);
 
     if (!for_each_pipe_line(out_error, lines, 0, *sep, true,
-                            [&](size_t i, const std::vector<std::string> &, const std::vector<std::string> &right) {
+                            [&](size_t i, std::string_view, std::string_view right) {
                                 return consume_column_clue_line(out_error, right, col_clues, i, lines[i]);
                             }))
         return false;
@@ -147,11 +191,22 @@ bool read_text_format(std::istream &in, Nonogram &out_puzzle, std::string &out_e
     const size_t row_begin = *sep + 1;
     const size_t row_end = std::min(lines.size(), row_begin + rows);
 
+    // grid bits go straight into row planes, CellGrid builds the columns from them in one go
+    const size_t grid_words = (cols + CellGrid::kWordBits - 1) / CellGrid::kWordBits;
+    std::vector<CellGrid::Word> grid_filled, grid_empty;
+    if (out_grid) {
+        grid_filled.assign(rows * grid_words, 0);
+        grid_empty.assign(rows * grid_words, 0);
+    }
     if (!for_each_pipe_line(out_error, lines, row_begin, row_end, false,
-                            [&](size_t i, const std::vector<std::string> &left, const std::vector<std::string> &) {
+                            [&](size_t i, std::string_view left, std::string_view right) {
                                 std::vector<int> row;
                                 if (!consume_row_clue_line(out_error, left, row, i, lines[i]))
                                     return false;
+                                const size_t offset = row_clues.size() * grid_words;
+                                if (out_grid && !consume_grid_line(out_error, right, cols, grid_filled.data() + offset,
+                                                                   grid_empty.data() + offset, i, lines[i]))
+                                    return false;
                                 row_clues.push_back(std::move(row));
                                 return true;
                             }))
@@ -159,6 +214,8 @@ bool read_text_format(std::istream &in, Nonogram &out_puzzle, std::string &out_e
 
     if (row_clues.size() != rows)
         return fail(out_error, wrong_row_count(row_clues.size(), rows));
+    if (out_grid)
+        out_grid->assign_rows(rows, cols, std::move(grid_filled), std::move(grid_empty));
 
     out_puzzle.row_clues = std::move(row_clues);
     out_puzzle.col_clues = std::move(col_clues);
@@ -166,4 +223,71 @@ bool read_text_format(std::istream &in, Nonogram &out_puzzle, std::string &out_e
     return true;
 }
 
+bool write_text_format(std::ostream &out, const Nonogram &puzzle, std::string &out_error) {
+    out_error.clear();
+    const size_t rows = puzzle.rows();
+    const size_t cols = puzzle.cols();
+
+    size_t row_slots = 0, col_slots = 0;
+    int widest = 1;
+    for (const auto &clues : puzzle.row_clues) {
+        row_slots = std::max(row_slots, clues.size());
+        for (const int clue : clues)
+            widest = std::max(widest, clue);
+    }
+    for (const auto &clues : puzzle.col_clues) {
+        col_slots = std::max(col_slots, clues.size());
+        for (const int clue : clues)
+            widest = std::max(widest, clue);
+    }
+    // every token gets the widest clue plus two spaces, like the hand made files
+    const size_t width = std::to_string(widest).size() + 2;
+    const std::string blank(width * row_slots, ' ');
+
+    out << rows << ' ' << cols << "\n\n";
+
+    // one line at a time, a 5000x5000 puzzle is a few hundred MB of text
+    std::string line;
+    for (size_t slot = 0; slot < col_slots; ++slot) {
+        line = blank;
+        line += '|';
+        for (const auto &clues : puzzle.col_clues)
+            append_field(line, clue_slot(clues, slot, col_slots), width);
+        line += '\n';
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+
+    line.assign(width * row_slots, '-');
+    line += '+';
+    line.append(width * cols, '-');
+    line += '\n';
+    out.write(line.data(), static_cast<std::streamsize>(line.size()));
+
+    // grid cells are the same two fields over and over
+    std::string filled_field, empty_field;
+    append_field(filled_field, "+", width);
+    append_field(empty_field, ".", width);
+    const bool has_grid = puzzle.cells.rows() == rows && puzzle.cells.cols() == cols;
+
+    for (size_t r = 0; r < rows; ++r) {
+        line.clear();
+        for (size_t slot = 0; slot < row_slots; ++slot) {
+            line += clue_slot(puzzle.row_clues[r], slot, row_slots);
+            line.resize(width * (slot + 1), ' ');
+        }
+        line += '|';
+        for (size_t c = 0; c < cols; ++c) {
+            const bool filled = has_grid && puzzle.cells.get(r, c) == Cell::Filled;
+            line += filled ? filled_field : empty_field;
+        }
+        line += '\n';
+        out.write(line.data(), static_cast<std::streamsize>(line.size()));
+    }
+
+    out.flush();
+    if (!out)
+        return fail(out_error, "Failed to write puzzle");
+    return true;
+}
+
 } // namespace TextFormat
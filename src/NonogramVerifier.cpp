@@ -0,0 +1,95 @@
+#include "../include/NonogramVerifier.h"
+
+#include <string>
+
+namespace {
+
+using Word = CellGrid::Word;
+constexpr size_t kWordBits = CellGrid::kWordBits;
+
+size_t trailing_zeros(Word w) {
+    return static_cast<size_t>(__builtin_ctzll(w));
+}
+
+} // namespace
+
+bool runs_match_clues(const Word *filled, size_t words, const std::vector<int> &clues) {
+    size_t next = 0;   // clue the next run has to match
+    size_t run = 0;    // length of the open run so far
+    bool open = false; // a run reaches the current position from the left
+    for (size_t i = 0; i < words; ++i) {
+        const Word w = filled[i];
+        size_t bit = 0;
+        while (bit < kWordBits) {
+            if (!open) {
+                const Word rest = w >> bit;
+                if (rest == 0)
+                    break;
+                bit += trailing_zeros(rest);
+                open = true;
+                run = 0;
+            }
+            // the run goes on up to the next 0, past this word if there is none
+            const Word gaps = ~w >> bit;
+            if (gaps == 0) {
+                run += kWordBits - bit;
+                break;
+            }
+            const size_t ones = trailing_zeros(gaps);
+            run += ones;
+            bit += ones;
+            if (next >= clues.size() || run != static_cast<size_t>(clues[next]))
+                return false;
+            ++next;
+            open = false;
+        }
+    }
+    // a run that ends with the last word
+    if (open) {
+        if (next >= clues.size() || run != static_cast<size_t>(clues[next]))
+            return false;
+        ++next;
+    }
+    return next == clues.size();
+}
+
+bool verify_grid(const Nonogram &puzzle, const CellGrid &grid, std::string &out_error, GridCheck *out_check) {
+    out_error.clear();
+    GridCheck check;
+    if (grid.rows() != puzzle.rows() || grid.cols() != puzzle.cols()) {
+        out_error = "Grid is " + std::to_string(grid.rows()) + "x" + std::to_string(grid.cols()) +
+                    " but the puzzle is " + std::to_string(puzzle.rows()) + "x" + std::to_string(puzzle.cols());
+        check.wrong_rows = puzzle.rows();
+        check.wrong_cols = puzzle.cols();
+        if (out_check)
+            *out_check = check;
+        return false;
+    }
+
+    // the first wrong row wins the message, then the first wrong column
+    size_t first_row = puzzle.rows(), first_col = puzzle.cols();
+    for (size_t r = 0; r < grid.rows(); ++r) {
+        check.unknown_cells += grid.unknown_in_row(r);
+        if (!runs_match_clues(grid.row_filled(r), grid.row_words(), puzzle.row_clues[r]) && check.wrong_rows++ == 0)
+            first_row = r;
+    }
+    for (size_t c = 0; c < grid.cols(); ++c)
+        if (!runs_match_clues(grid.col_filled(c), grid.col_words(), puzzle.col_clues[c]) && check.wrong_cols++ == 0)
+            first_col = c;
+    if (out_check)
+        *out_check = check;
+
+    if (check.unknown_cells > 0)
+        out_error = "Grid has " + std::to_string(check.unknown_cells) + " unknown cells";
+    else if (check.wrong_rows > 0)
+        out_error = "Row " + std::to_string(first_row + 1) + " doesn't match its clues";
+    else if (check.wrong_cols > 0)
+        out_error = "Column " + std::to_string(first_col + 1) + " doesn't match its clues";
+    else
+        return true;
+
+    if (check.wrong_rows + check.wrong_cols > 1)
+        out_error += " (" + std::to_string(check.wrong_rows) + " rows and " + std::to_string(check.wrong_cols) +
+                     " columns wrong)";
+    return false;
+}
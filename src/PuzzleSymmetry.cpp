@@ -0,0 +1,217 @@
+#include "../include/PuzzleSymmetry.h"
+#include "../include/NonogramBinaryFormat.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Word = CellGrid::Word;
+constexpr size_t kWordBits = CellGrid::kWordBits;
+
+Word reverse_bits(Word w) {
+    w = ((w >> 1) & 0x5555555555555555ull) | ((w & 0x5555555555555555ull) << 1);
+    w = ((w >> 2) & 0x3333333333333333ull) | ((w & 0x3333333333333333ull) << 2);
+    w = ((w >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((w & 0x0F0F0F0F0F0F0F0Full) << 4);
+    return __builtin_bswap64(w);
+}
+
+// Both planes of a grid in row order, the layout CellGrid::assign_rows takes
+struct Planes {
+    size_t rows = 0;
+    size_t cols = 0;
+    size_t words = 0; // per row
+    std::vector<Word> filled;
+    std::vector<Word> empty;
+};
+
+Planes row_planes(const CellGrid &grid) {
+    Planes p;
+    p.rows = grid.rows();
+    p.cols = grid.cols();
+    p.words = grid.row_words();
+    p.filled.reserve(p.rows * p.words);
+    p.empty.reserve(p.rows * p.words);
+    for (size_t r = 0; r < p.rows; ++r) {
+        p.filled.insert(p.filled.end(), grid.row_filled(r), grid.row_filled(r) + p.words);
+        p.empty.insert(p.empty.end(), grid.row_empty(r), grid.row_empty(r) + p.words);
+    }
+    return p;
+}
+
+// The column planes read as row planes: the grid transposed, no bit moves
+Planes col_planes(const CellGrid &grid) {
+    Planes p;
+    p.rows = grid.cols();
+    p.cols = grid.rows();
+    p.words = grid.col_words();
+    p.filled.reserve(p.rows * p.words);
+    p.empty.reserve(p.rows * p.words);
+    for (size_t c = 0; c < p.rows; ++c) {
+        p.filled.insert(p.filled.end(), grid.col_filled(c), grid.col_filled(c) + p.words);
+        p.empty.insert(p.empty.end(), grid.col_empty(c), grid.col_empty(c) + p.words);
+    }
+    return p;
+}
+
+// Reverses the cells of every row in place: the words in reverse order with their bits reversed,
+// then everything shifted down by the padding that ended up in front
+void mirror_rows(std::vector<Word> &plane, size_t rows, size_t cols, size_t words) {
+    const size_t shift = words * kWordBits - cols;
+    for (size_t r = 0; r < rows; ++r) {
+        Word *line = plane.data() + r * words;
+        std::reverse(line, line + words);
+        for (size_t w = 0; w < words; ++w)
+            line[w] = reverse_bits(line[w]);
+        if (shift == 0)
+            continue;
+        for (size_t w = 0; w < words; ++w) {
+            const Word next = w + 1 < words ? line[w + 1] : 0;
+            line[w] = (line[w] >> shift) | (next << (kWordBits - shift));
+        }
+    }
+}
+
+void flip_rows(std::vector<Word> &plane, size_t rows, size_t words) {
+    for (size_t top = 0, bottom = rows; top + 1 < bottom; ++top, --bottom)
+        std::swap_ranges(plane.begin() + top * words, plane.begin() + (top + 1) * words,
+                         plane.begin() + (bottom - 1) * words);
+}
+
+void flip(Planes &p, Symmetry symmetry) {
+    if (symmetry.flip_horizontal) {
+        mirror_rows(p.filled, p.rows, p.cols, p.words);
+        mirror_rows(p.empty, p.rows, p.cols, p.words);
+    }
+    if (symmetry.flip_vertical) {
+        flip_rows(p.filled, p.rows, p.words);
+        flip_rows(p.empty, p.rows, p.words);
+    }
+}
+
+CellGrid to_grid(Planes p) {
+    CellGrid grid;
+    grid.assign_rows(p.rows, p.cols, std::move(p.filled), std::move(p.empty));
+    return grid;
+}
+
+// One side's clues (rows or columns) of a turned puzzle, read in place from the untouched puzzle
+struct LineView {
+    const std::vector<std::vector<int>> *lines;
+    bool reverse_order; // line i is lines[size-1-i]
+    bool reverse_each;  // a line's clues read back to front
+
+    size_t size() const { return lines->size(); }
+    const std::vector<int> &line(size_t i) const { return (*lines)[reverse_order ? size() - 1 - i : i]; }
+    int clue(const std::vector<int> &l, size_t j) const { return l[reverse_each ? l.size() - 1 - j : j]; }
+};
+
+struct PuzzleView {
+    LineView rows;
+    LineView cols;
+};
+
+PuzzleView view(const Nonogram &puzzle, Symmetry symmetry) {
+    PuzzleView v{{&puzzle.row_clues, symmetry.flip_vertical, symmetry.flip_horizontal},
+                 {&puzzle.col_clues, symmetry.flip_horizontal, symmetry.flip_vertical}};
+    if (symmetry.transpose)
+        std::swap(v.rows, v.cols);
+    return v;
+}
+
+// -1, 0 or 1 as a is before, the same as or after b
+template <typename T> int compare(T a, T b) {
+    return a < b ? -1 : b < a ? 1 : 0;
+}
+
+int compare_counts(const LineView &a, const LineView &b) {
+    for (size_t i = 0; i < a.size(); ++i)
+        if (const int c = compare(a.line(i).size(), b.line(i).size()))
+            return c;
+    return 0;
+}
+
+// Both sides have the same counts by now
+int compare_runs(const LineView &a, const LineView &b) {
+    for (size_t i = 0; i < a.size(); ++i) {
+        const std::vector<int> &la = a.line(i);
+        const std::vector<int> &lb = b.line(i);
+        for (size_t j = 0; j < la.size(); ++j)
+            if (const int c = compare(a.clue(la, j), b.clue(lb, j)))
+                return c;
+    }
+    return 0;
+}
+
+// Orders turned puzzles by size, then clue counts, then clues. Usually settled by the first few lines,
+// so choosing among the 8 costs next to nothing and only the winner gets copied and encoded.
+int compare_puzzles(const PuzzleView &a, const PuzzleView &b) {
+    if (const int c = compare(a.rows.size(), b.rows.size()))
+        return c;
+    if (const int c = compare_counts(a.rows, b.rows))
+        return c;
+    if (const int c = compare_counts(a.cols, b.cols))
+        return c;
+    if (const int c = compare_runs(a.rows, b.rows))
+        return c;
+    return compare_runs(a.cols, b.cols);
+}
+
+} // namespace
+
+Symmetry symmetry_from_index(int index) {
+    Symmetry symmetry;
+    symmetry.flip_horizontal = (index & 1) != 0;
+    symmetry.flip_vertical = (index & 2) != 0;
+    symmetry.transpose = (index & 4) != 0;
+    return symmetry;
+}
+
+Nonogram transform_clues(const Nonogram &puzzle, Symmetry symmetry) {
+    Nonogram out;
+    out.row_clues = puzzle.row_clues;
+    out.col_clues = puzzle.col_clues;
+    if (symmetry.flip_horizontal) {
+        for (auto &clues : out.row_clues)
+            std::reverse(clues.begin(), clues.end());
+        std::reverse(out.col_clues.begin(), out.col_clues.end());
+    }
+    if (symmetry.flip_vertical) {
+        std::reverse(out.row_clues.begin(), out.row_clues.end());
+        for (auto &clues : out.col_clues)
+            std::reverse(clues.begin(), clues.end());
+    }
+    if (symmetry.transpose)
+        std::swap(out.row_clues, out.col_clues);
+    return out;
+}
+
+CellGrid transform_grid(const CellGrid &grid, Symmetry symmetry) {
+    Planes p = row_planes(grid);
+    flip(p, symmetry);
+    CellGrid flipped = to_grid(std::move(p));
+    return symmetry.transpose ? to_grid(col_planes(flipped)) : flipped;
+}
+
+CellGrid inverse_transform_grid(const CellGrid &grid, Symmetry symmetry) {
+    // flips undo themselves and commute, so the inverse is the transpose first and the same flips after
+    Planes p = symmetry.transpose ? col_planes(grid) : row_planes(grid);
+    flip(p, symmetry);
+    return to_grid(std::move(p));
+}
+
+Symmetry canonical_symmetry(const Nonogram &puzzle, std::string &out_key) {
+    Symmetry best;
+    PuzzleView best_view = view(puzzle, best);
+    for (int i = 1; i < kSymmetryCount; ++i) {
+        const Symmetry symmetry = symmetry_from_index(i);
+        const PuzzleView v = view(puzzle, symmetry);
+        if (compare_puzzles(v, best_view) < 0) {
+            best = symmetry;
+            best_view = v;
+        }
+    }
+    out_key = BinaryFormat::to_binary_format(transform_clues(puzzle, best));
+    return best;
+}
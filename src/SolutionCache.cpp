@@ -0,0 +1,259 @@
+#include "../include/SolutionCache.h"
+#include "../include/NonogramVerifier.h"
+#include "../include/PuzzleSymmetry.h"
+#include "../include/core/MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace {
+
+namespace fs = std::filesystem;
+using Word = CellGrid::Word;
+
+constexpr char kMagic[4] = {'N', 'G', 'S', 'C'};
+constexpr unsigned char kVersion = 1;
+constexpr size_t kHeaderBytes = sizeof(kMagic) + 1 + 4;
+constexpr const char *kExtension = ".ngsol";
+constexpr const char *kTempPrefix = ".tmp-";
+constexpr size_t kScanInterval = 256;
+// a temporary file this old belongs to a writer that died, younger ones may still be being written
+constexpr auto kStaleTemp = std::chrono::hours(1);
+
+std::uint64_t fnv1a(const std::string &bytes) {
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char ch : bytes) {
+        hash ^= static_cast<unsigned char>(ch);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+std::string hex(std::uint64_t value) {
+    static const char *digits = "0123456789abcdef";
+    std::string out(16, '0');
+    for (size_t i = 16; i-- > 0; value >>= 4)
+        out[i] = digits[value & 0xF];
+    return out;
+}
+
+void put_u32(std::string &out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i)
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+void put_word(std::string &out, Word value) {
+    for (int i = 0; i < 8; ++i)
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+Word get_word(const char *p) {
+    Word value = 0;
+    for (int i = 0; i < 8; ++i)
+        value |= static_cast<Word>(static_cast<unsigned char>(p[i])) << (8 * i);
+    return value;
+}
+
+// Bits of the last word of a line that belong to the line
+Word tail_mask(size_t length) {
+    const size_t used = length % CellGrid::kWordBits;
+    return used == 0 ? ~Word{0} : (Word{1} << used) - 1;
+}
+
+// Cells decided in given that grid disagrees with, both the same size
+bool contradicts(const CellGrid &given, const CellGrid &grid) {
+    for (size_t r = 0; r < given.rows(); ++r) {
+        for (size_t w = 0; w < given.row_words(); ++w) {
+            const Word filled = grid.row_filled(r)[w];
+            if ((given.row_filled(r)[w] & ~filled) | (given.row_empty(r)[w] & filled))
+                return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+SolutionCache::SolutionCache(std::string directory, std::uint64_t max_bytes)
+    : directory_(std::move(directory)), max_bytes_(max_bytes) {
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+    ok_ = fs::is_directory(directory_, ec);
+
+    std::random_device random;
+    tag_ = (static_cast<std::uint64_t>(random()) << 32) ^ random() ^
+           static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    if (ok_) {
+        std::lock_guard<std::mutex> lock(size_mutex_);
+        evict();
+    }
+}
+
+std::string SolutionCache::path_for(const std::string &key) const {
+    return (fs::path(directory_) / (hex(fnv1a(key)) + kExtension)).string();
+}
+
+bool SolutionCache::lookup(Nonogram &puzzle) {
+    if (!ok_ || puzzle.rows() == 0 || puzzle.cols() == 0)
+        return false;
+
+    std::string key;
+    const Symmetry symmetry = canonical_symmetry(puzzle, key);
+    const std::string path = path_for(key);
+
+    CellGrid grid;
+    {
+        nonogram::core::MappedFile file;
+        if (!file.open(path))
+            return false;
+        const std::string_view data = file.view();
+        if (data.size() < kHeaderBytes || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0 ||
+            static_cast<unsigned char>(data[sizeof(kMagic)]) != kVersion)
+            return false;
+        std::uint32_t key_size = 0;
+        for (int i = 0; i < 4; ++i)
+            key_size |= static_cast<std::uint32_t>(static_cast<unsigned char>(data[sizeof(kMagic) + 1 + i])) << (8 * i);
+
+        // the canonical grid is the puzzle's own turned by symmetry
+        const size_t rows = symmetry.transpose ? puzzle.cols() : puzzle.rows();
+        const size_t cols = symmetry.transpose ? puzzle.rows() : puzzle.cols();
+        const size_t words = (cols + CellGrid::kWordBits - 1) / CellGrid::kWordBits;
+        if (key_size != key.size() || data.size() != kHeaderBytes + key.size() + rows * words * 8 ||
+            data.compare(kHeaderBytes, key.size(), key) != 0)
+            return false;
+
+        const char *p = data.data() + kHeaderBytes + key.size();
+        const Word tail = tail_mask(cols);
+        std::vector<Word> filled(rows * words);
+        std::vector<Word> empty(rows * words);
+        for (size_t i = 0; i < filled.size(); ++i, p += 8) {
+            const Word mask = i % words == words - 1 ? tail : ~Word{0};
+            filled[i] = get_word(p) & mask;
+            empty[i] = ~filled[i] & mask;
+        }
+        grid.assign_rows(rows, cols, std::move(filled), std::move(empty));
+    }
+
+    grid = inverse_transform_grid(grid, symmetry);
+    std::string error;
+    if (!verify_grid(puzzle, grid, error))
+        return false;
+    const bool has_givens = puzzle.cells.rows() == puzzle.rows() && puzzle.cells.cols() == puzzle.cols();
+    if (has_givens && contradicts(puzzle.cells, grid))
+        return false;
+    puzzle.cells.swap(grid);
+
+    // the modification time is the last use, eviction goes by it
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return true;
+}
+
+bool SolutionCache::store(const Nonogram &puzzle, std::string &out_error) {
+    out_error.clear();
+    if (!ok_) {
+        out_error = "SolutionCache: no cache directory " + directory_;
+        return false;
+    }
+
+    std::string key;
+    const Symmetry symmetry = canonical_symmetry(puzzle, key);
+    const CellGrid grid = transform_grid(puzzle.cells, symmetry);
+
+    std::string bytes(kMagic, sizeof(kMagic));
+    bytes += static_cast<char>(kVersion);
+    put_u32(bytes, static_cast<std::uint32_t>(key.size()));
+    bytes += key;
+    bytes.reserve(bytes.size() + grid.rows() * grid.row_words() * 8);
+    for (size_t r = 0; r < grid.rows(); ++r)
+        for (size_t w = 0; w < grid.row_words(); ++w)
+            put_word(bytes, grid.row_filled(r)[w]);
+
+    // written in full under a name no one else uses, then renamed over the real one in one step
+    const std::string path = path_for(key);
+    const std::string temp = (fs::path(directory_) / (kTempPrefix + hex(tag_) + "-" + std::to_string(next_temp_++))).string();
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        out.close();
+        if (!out) {
+            std::error_code ec;
+            fs::remove(temp, ec);
+            out_error = "SolutionCache: failed to write " + temp;
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temp, path, ec);
+    if (ec) {
+        // where renaming can't replace a file, the one there is another process's copy of the same grid
+        std::error_code ignored;
+        fs::remove(temp, ignored);
+        if (!fs::exists(path, ignored)) {
+            out_error = "SolutionCache: failed to rename " + temp + " to " + path;
+            return false;
+        }
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(size_mutex_);
+    estimated_bytes_ += bytes.size();
+    if (estimated_bytes_ > max_bytes_ || ++stores_since_scan_ >= kScanInterval)
+        evict();
+    return true;
+}
+
+void SolutionCache::evict() {
+    struct Entry {
+        fs::path path;
+        std::uint64_t size = 0;
+        fs::file_time_type used;
+    };
+    std::vector<Entry> entries;
+    std::uint64_t total = 0;
+    const auto now = fs::file_time_type::clock::now();
+
+    // other processes add and remove files while this runs, anything that fails is skipped
+    std::error_code ec;
+    for (fs::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+        std::error_code entry_ec;
+        const fs::path &path = it->path();
+        const std::string name = path.filename().string();
+        const auto used = fs::last_write_time(path, entry_ec);
+        if (entry_ec)
+            continue;
+        if (name.rfind(kTempPrefix, 0) == 0) {
+            if (now - used > kStaleTemp)
+                fs::remove(path, entry_ec);
+            continue;
+        }
+        if (path.extension() != kExtension)
+            continue;
+        const std::uint64_t size = fs::file_size(path, entry_ec);
+        if (entry_ec)
+            continue;
+        entries.push_back({path, size, used});
+        total += size;
+    }
+
+    if (total > max_bytes_) {
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.used < b.used; });
+        const std::uint64_t target = max_bytes_ / 10 * 9;
+        for (const Entry &entry : entries) {
+            if (total <= target)
+                break;
+            std::error_code remove_ec;
+            fs::remove(entry.path, remove_ec);
+            total -= entry.size;
+        }
+    }
+    estimated_bytes_ = total;
+    stores_since_scan_ = 0;
+}
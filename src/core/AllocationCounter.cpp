@@ -0,0 +1,36 @@
+#include "../../include/core/AllocationCounter.h"
+
+#ifdef NONOGRAM_COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::size_t> g_allocations{0};
+
+void *counted_alloc(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+} // namespace
+
+void *operator new(std::size_t size) { return counted_alloc(size); }
+void *operator new[](std::size_t size) { return counted_alloc(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+
+namespace nonogram::core {
+std::size_t allocation_count() { return g_allocations.load(std::memory_order_relaxed); }
+} // namespace nonogram::core
+
+#else
+
+namespace nonogram::core {
+std::size_t allocation_count() { return 0; }
+} // namespace nonogram::core
+
+#endif
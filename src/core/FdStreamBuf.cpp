@@ -0,0 +1,79 @@
+#include "../../include/core/FdStreamBuf.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace nonogram::core {
+
+FdStreamBuf::FdStreamBuf(int fd, std::size_t buffer_size) : fd_(fd), buffer_(std::max<std::size_t>(1, buffer_size)) {
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+}
+
+FdStreamBuf::~FdStreamBuf() {
+    flush_buffer();
+}
+
+bool FdStreamBuf::write_all(const char *data, std::size_t size) {
+    while (size > 0) {
+#ifdef _WIN32
+        const int chunk = static_cast<int>(std::min<std::size_t>(size, 1u << 30));
+        const int written = _write(fd_, data, static_cast<unsigned>(chunk));
+#else
+        const ssize_t written = ::write(fd_, data, size);
+#endif
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+bool FdStreamBuf::flush_buffer() {
+    const std::size_t pending = static_cast<std::size_t>(pptr() - pbase());
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+    return write_all(buffer_.data(), pending);
+}
+
+FdStreamBuf::int_type FdStreamBuf::overflow(int_type ch) {
+    if (!flush_buffer())
+        return traits_type::eof();
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize FdStreamBuf::xsputn(const char *s, std::streamsize n) {
+    const std::size_t size = static_cast<std::size_t>(n);
+    if (size <= static_cast<std::size_t>(epptr() - pptr())) {
+        std::memcpy(pptr(), s, size);
+        pbump(static_cast<int>(n));
+        return n;
+    }
+    // doesn't fit: what's buffered goes first, then a big block straight through or a small one into the buffer
+    if (!flush_buffer())
+        return 0;
+    if (size >= buffer_.size())
+        return write_all(s, size) ? n : 0;
+    std::memcpy(pptr(), s, size);
+    pbump(static_cast<int>(n));
+    return n;
+}
+
+int FdStreamBuf::sync() {
+    return flush_buffer() ? 0 : -1;
+}
+
+} // namespace nonogram::core
@@ -0,0 +1,119 @@
+#include "../../include/core/MappedFile.h"
+
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace nonogram::core {
+
+namespace {
+
+// Maps path into out_data. out_data stays null when it isn't a regular non-empty file or mapping fails,
+// false only when the file can't be opened at all.
+#ifdef _WIN32
+
+bool map_file(const std::string &path, const char *&out_data, std::size_t &out_size) {
+    out_data = nullptr;
+    out_size = 0;
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size{};
+    if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        // the view keeps the mapping alive, both handles can go right away
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            const void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (view) {
+                out_data = static_cast<const char *>(view);
+                out_size = static_cast<std::size_t>(size.QuadPart);
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    return true;
+}
+
+void unmap_file(const char *data, std::size_t) {
+    UnmapViewOfFile(data);
+}
+
+#else
+
+bool map_file(const std::string &path, const char *&out_data, std::size_t &out_size) {
+    out_data = nullptr;
+    out_size = 0;
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st {};
+    if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        // the mapping outlives the descriptor
+        void *view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            ::madvise(view, static_cast<std::size_t>(st.st_size), MADV_SEQUENTIAL);
+            out_data = static_cast<const char *>(view);
+            out_size = static_cast<std::size_t>(st.st_size);
+        }
+    }
+    ::close(fd);
+    return true;
+}
+
+void unmap_file(const char *data, std::size_t size) {
+    ::munmap(const_cast<char *>(data), size);
+}
+
+#endif
+
+} // namespace
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string &path) {
+    close();
+    if (!map_file(path, data_, size_))
+        return false;
+    if (data_) {
+        mapped_ = true;
+        return true;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+    fallback_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (in.bad())
+        return false;
+    data_ = fallback_.data();
+    size_ = fallback_.size();
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapped_)
+        unmap_file(data_, size_);
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    fallback_.clear();
+}
+
+} // namespace nonogram::core
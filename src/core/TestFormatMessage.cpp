@@ -33,6 +33,10 @@ std::string wrong_row_count(std::size_t got, std::size_t expected) {
     return "Expected " + std::to_string(expected) +
            " row lines after separator, got " + std::to_string(got) + ".";
 }
+std::string wrong_grid_cell_count(std::size_t got, std::size_t expected) {
+    return "Row-clue line has " + std::to_string(got) +
+           " grid cells on the right, expected " + std::to_string(expected) + ".";
+}
 
 // Token issues
 std::string empty_token() {
@@ -44,6 +48,9 @@ std::string invalid_integer_token(std::string_view token) {
 std::string non_positive_clue(std::string_view token) {
     return "Non-positive clue: '" + std::string(token) + "'";
 }
+std::string invalid_grid_cell(std::string_view token) {
+    return "Invalid grid cell: '" + std::string(token) + "' (expected + or .)";
+}
 std::string with_line(std::string_view msg, std::size_t i, std::string_view line) {
     return std::string(msg) + "\nLine " + std::to_string(i + 1) + ":\n\"" + std::string(line) + "\"";
 }
@@ -2,29 +2,38 @@
 #include "../../include/core/enums.h"
 
 #include <cctype>
-#include <sstream>
+#include <limits>
+#include <utility>
 
 namespace nonogram::io::textformat {
 
-std::string trim(const std::string &s) {
+std::string_view trim(std::string_view s) {
     size_t first = 0;
-    while (first < s.size() && std::isspace(static_cast<unsigned char>(s[first])))
+    while (first < s.size() && is_space(s[first]))
         ++first;
 
     size_t last = s.size();
-    while (last > first && std::isspace(static_cast<unsigned char>(s[last - 1])))
+    while (last > first && is_space(s[last - 1]))
         --last;
 
     return s.substr(first, last - first);
 }
 
-std::vector<std::string> split_ws(const std::string &s) {
-    std::istringstream iss(s);
-    std::vector<std::string> out;
-    std::string tok;
-    while (iss >> tok)
-        out.push_back(tok);
-    return out;
+std::string_view next_token(std::string_view s, std::size_t &pos) {
+    while (pos < s.size() && is_space(s[pos]))
+        ++pos;
+    const size_t begin = pos;
+    while (pos < s.size() && !is_space(s[pos]))
+        ++pos;
+    return s.substr(begin, pos - begin);
+}
+
+std::size_t count_tokens(std::string_view s) {
+    size_t count = 0;
+    size_t pos = 0;
+    while (!next_token(s, pos).empty())
+        ++count;
+    return count;
 }
 
 bool fail(std::string &out_error, std::string msg) {
@@ -32,16 +41,16 @@ bool fail(std::string &out_error, std::string msg) {
     return false;
 }
 
-bool split_pipe(const std::string &line, std::string &left, std::string &right) {
+bool split_pipe(std::string_view line, std::string_view &left, std::string_view &right) {
     const auto pos = line.find('|');
-    if (pos == std::string::npos)
+    if (pos == std::string_view::npos)
         return false;
     left = line.substr(0, pos);
     right = line.substr(pos + 1);
     return true;
 }
 
-bool is_separator_line(const std::string &line) {
+bool is_separator_line(std::string_view line) {
     bool has_plus = false;
     bool has_dash = false;
 
@@ -88,4 +97,32 @@ TokenParseKind parse_positive_int_token(const std::string_view token,
     return TokenParseKind::Value;
 }
 
+bool scan_int(std::string_view text, std::size_t &pos, int &out_value) {
+    while (pos < text.size() && is_space(text[pos]))
+        ++pos;
+
+    bool negative = false;
+    if (pos < text.size() && (text[pos] == '+' || text[pos] == '-'))
+        negative = text[pos++] == '-';
+
+    // magnitude limit, one more on the negative side
+    const long long limit = negative ? -static_cast<long long>(std::numeric_limits<int>::min())
+                                     : std::numeric_limits<int>::max();
+    long long value = 0;
+    bool in_range = true;
+    const size_t digits_begin = pos;
+    while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+        if (in_range) {
+            value = value * 10 + (text[pos] - '0');
+            in_range = value <= limit;
+        }
+        ++pos;
+    }
+    if (pos == digits_begin || !in_range)
+        return false;
+
+    out_value = static_cast<int>(negative ? -value : value);
+    return true;
+}
+
 } // namespace nonogram::io::textformat
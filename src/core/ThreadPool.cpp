@@ -0,0 +1,72 @@
+#include "../../include/core/ThreadPool.h"
+
+#include <algorithm>
+
+namespace nonogram::core {
+
+ThreadPool::ThreadPool(int threads) {
+    for (int worker = 1; worker < std::max(1, threads); ++worker)
+        threads_.emplace_back(&ThreadPool::worker_loop, this, worker);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        shutdown_ = true;
+    }
+    wake_.notify_all();
+    for (auto &t : threads_)
+        t.join();
+}
+
+void ThreadPool::run(size_t count, const std::function<void(int worker, size_t index)> &job) {
+    if (threads_.empty() || count <= 1) {
+        for (size_t i = 0; i < count; ++i)
+            job(0, i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        job_ = &job;
+        count_ = count;
+        next_.store(0);
+        busy_ = static_cast<int>(threads_.size());
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    drain(0);
+
+    std::unique_lock<std::mutex> lock(m_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+    job_ = nullptr;
+}
+
+void ThreadPool::drain(int worker) {
+    for (size_t i = next_.fetch_add(1); i < count_; i = next_.fetch_add(1))
+        (*job_)(worker, i);
+}
+
+void ThreadPool::worker_loop(int worker) {
+    std::size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            wake_.wait(lock, [&] { return shutdown_ || generation_ != seen; });
+            if (shutdown_)
+                return;
+            seen = generation_;
+        }
+
+        drain(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            --busy_;
+        }
+        done_.notify_one();
+    }
+}
+
+} // namespace nonogram::core
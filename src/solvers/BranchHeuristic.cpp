@@ -0,0 +1,209 @@
+#include "../../include/solvers/BranchHeuristic.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+const char *branch_rule_name(BranchRule rule) {
+    switch (rule) {
+    case BranchRule::FirstUnknown:
+        return "first-unknown";
+    case BranchRule::MostConstrainedLine:
+        return "most-constrained-line";
+    case BranchRule::ProbeImpact:
+        return "probe-impact";
+    default:
+        return "unknown";
+    }
+}
+
+const char *value_order_name(ValueOrder order) {
+    switch (order) {
+    case ValueOrder::FilledFirst:
+        return "filled-first";
+    case ValueOrder::EmptyFirst:
+        return "empty-first";
+    case ValueOrder::Feasibility:
+        return "feasibility";
+    default:
+        return "unknown";
+    }
+}
+
+BranchHeuristic::BranchHeuristic(ValueOrder order, int R, int C) : order_(order) {
+    row_unknown_.assign(R, 0);
+    col_unknown_.assign(C, 0);
+    filled_counts_.reserve(std::max(R, C));
+    empty_counts_.reserve(std::max(R, C));
+}
+
+bool BranchHeuristic::decide(SolveContext &ctx, DomainGrid &g, int from, BranchDecision &out) {
+    const int cell = pick_cell(ctx, g, from);
+    if (cell < 0)
+        return false;
+
+    out.cell = cell;
+    out.first = first_value(ctx, g, cell);
+    out.second = out.first == D_FILLED ? D_EMPTY : D_FILLED;
+    return true;
+}
+
+void BranchHeuristic::count_unknowns(const DomainGrid &g) {
+    for (int r = 0; r < g.R; ++r)
+        row_unknown_[r] = static_cast<int>(g.cells.unknown_in_row(r));
+    for (int c = 0; c < g.C; ++c)
+        col_unknown_[c] = static_cast<int>(g.cells.unknown_in_col(c));
+}
+
+std::uint8_t BranchHeuristic::first_value(SolveContext &ctx, const DomainGrid &g, int cell) {
+    if (order_ == ValueOrder::FilledFirst)
+        return D_FILLED;
+    if (order_ == ValueOrder::EmptyFirst)
+        return D_EMPTY;
+
+    // Treat the row and the column as independent votes on the cell
+    const int r = cell / g.C;
+    const int c = cell % g.C;
+    const double p_row = filled_share(ctx, g, true, r, c);
+    const double p_col = filled_share(ctx, g, false, c, r);
+    return p_row * p_col >= (1.0 - p_row) * (1.0 - p_col) ? D_FILLED : D_EMPTY;
+}
+
+double BranchHeuristic::filled_share(SolveContext &ctx, const DomainGrid &g, bool is_row, int idx, int pos) {
+    const LineAutomaton &automaton = is_row ? ctx.lines.rows[idx] : ctx.lines.cols[idx];
+
+    ctx.line_domains.assign(is_row ? g.C : g.R, 0);
+    g.read_line(is_row, idx, ctx.line_domains.data());
+
+    if (!count_line_completions(automaton, ctx.line_domains, filled_counts_, empty_counts_, ctx.scratch))
+        return 0.5;
+    const double total = filled_counts_[pos] + empty_counts_[pos];
+    return total > 0.0 ? filled_counts_[pos] / total : 0.5;
+}
+
+namespace {
+
+class FirstUnknownHeuristic : public BranchHeuristic {
+  public:
+    using BranchHeuristic::BranchHeuristic;
+
+  protected:
+    int pick_cell(SolveContext &, DomainGrid &g, int from) override {
+        return pick_branch_cell(g, from);
+    }
+};
+
+class MostConstrainedLineHeuristic : public BranchHeuristic {
+  public:
+    using BranchHeuristic::BranchHeuristic;
+
+  protected:
+    int pick_cell(SolveContext &, DomainGrid &g, int) override {
+        count_unknowns(g);
+
+        // Line with the fewest undecided cells left, it's the one closest to being settled
+        bool best_is_row = true;
+        int best_idx = -1;
+        int best_unknown = 0;
+        auto consider = [&](bool is_row, int idx, int unknown) {
+            if (unknown > 0 && (best_idx < 0 || unknown < best_unknown)) {
+                best_is_row = is_row;
+                best_idx = idx;
+                best_unknown = unknown;
+            }
+        };
+        for (int r = 0; r < g.R; ++r)
+            consider(true, r, row_unknown_[r]);
+        for (int c = 0; c < g.C; ++c)
+            consider(false, c, col_unknown_[c]);
+        if (best_idx < 0)
+            return -1;
+
+        // Inside it, the cell whose crossing line is the most constrained too
+        const int len = best_is_row ? g.C : g.R;
+        int best_cell = -1;
+        int best_cross = 0;
+        for (int i = 0; i < len; ++i) {
+            const int cell = best_is_row ? best_idx * g.C + i : i * g.C + best_idx;
+            if (popcount2(g.get(cell)) != 2)
+                continue;
+            const int cross = best_is_row ? col_unknown_[i] : row_unknown_[i];
+            if (best_cell < 0 || cross < best_cross) {
+                best_cell = cell;
+                best_cross = cross;
+            }
+        }
+        return best_cell;
+    }
+};
+
+// Probing every undecided cell at every node costs two propagations per cell,
+// so only the cells on the most constrained crossings get probed.
+constexpr size_t kProbeCandidates = 24;
+
+class ProbeImpactHeuristic : public BranchHeuristic {
+  public:
+    ProbeImpactHeuristic(ValueOrder order, int R, int C) : BranchHeuristic(order, R, C) {
+        candidates_.reserve(static_cast<size_t>(R) * C);
+    }
+
+  protected:
+    int pick_cell(SolveContext &ctx, DomainGrid &g, int) override {
+        count_unknowns(g);
+
+        candidates_.clear();
+        const size_t total = static_cast<size_t>(g.R) * g.C;
+        for (size_t idx = g.cells.next_unknown(0); idx < total; idx = g.cells.next_unknown(idx + 1))
+            candidates_.push_back({row_unknown_[idx / g.C] + col_unknown_[idx % g.C], static_cast<int>(idx)});
+        if (candidates_.empty())
+            return -1;
+
+        const size_t n = std::min(kProbeCandidates, candidates_.size());
+        std::partial_sort(candidates_.begin(), candidates_.begin() + n, candidates_.end());
+
+        // Score a cell by what its weaker value fixes, a cell only good on one side
+        // still leaves a big subtree on the other
+        int best_cell = candidates_[0].second;
+        size_t best_score = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const int cell = candidates_[i].second;
+            size_t impact[2];
+            int k = 0;
+            for (const std::uint8_t value : {D_FILLED, D_EMPTY}) {
+                const size_t mark = ctx.trail.mark();
+                const bool ok = assign_and_propagate(ctx, g, cell, value);
+                impact[k++] = ctx.trail.mark() - mark;
+                ctx.trail.undo_to(g, mark);
+
+                // A failing value settles the cell right away, nothing scores better than that
+                if (!ok)
+                    return cell;
+            }
+
+            const size_t score = std::min(impact[0], impact[1]);
+            if (score > best_score) {
+                best_score = score;
+                best_cell = cell;
+            }
+        }
+        return best_cell;
+    }
+
+  private:
+    std::vector<std::pair<int, int>> candidates_; // (crossing unknowns, cell)
+};
+
+} // namespace
+
+std::unique_ptr<BranchHeuristic> make_branch_heuristic(BranchRule rule, ValueOrder order, int R, int C) {
+    switch (rule) {
+    case BranchRule::MostConstrainedLine:
+        return std::make_unique<MostConstrainedLineHeuristic>(order, R, C);
+    case BranchRule::ProbeImpact:
+        return std::make_unique<ProbeImpactHeuristic>(order, R, C);
+    default:
+        return std::make_unique<FirstUnknownHeuristic>(order, R, C);
+    }
+}
@@ -0,0 +1,268 @@
+#include "../../include/solvers/DPSearch.h"
+#include "../../include/solvers/BranchHeuristic.h"
+#include "../../include/solvers/FailedLiteralProber.h"
+#include "../../include/solvers/WorkStealingSearch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+const char *branch_mode_name(BranchMode mode) {
+    switch (mode) {
+    case BranchMode::Cells:
+        return "cells";
+    case BranchMode::Lines:
+        return "lines";
+    default:
+        return "unknown";
+    }
+}
+
+SolveContext::SolveContext(const PuzzleAutomata &lines, LineKernel kernel, LineSchedule schedule, int R, int C)
+    : lines(lines), kernel(kernel) {
+    scratch.reserve(lines);
+    q.reset(schedule, lines);
+    line_domains.reserve(std::max(R, C));
+    new_line_domains.reserve(std::max(R, C));
+
+    // Domains only shrink from both values to one, so a cell is written at most once
+    // between the root and any node, and every frame branches on a different cell.
+    trail.reserve(static_cast<size_t>(R) * C);
+    stack.reserve(static_cast<size_t>(R) * C);
+    completions_filled.reserve(std::max(R, C));
+    completions_empty.reserve(std::max(R, C));
+}
+
+SolverStats SolveContext::totals() const {
+    SolverStats out = stats;
+    out.queue_pushes += q.pushes();
+    return out;
+}
+
+bool out_of_budget(SolveContext &ctx) {
+    if (!ctx.budget)
+        return false;
+    if (ctx.stats.nodes != ctx.budget_nodes) {
+        ctx.budget->add_nodes(ctx.stats.nodes - ctx.budget_nodes);
+        ctx.budget_nodes = ctx.stats.nodes;
+    }
+    if (++ctx.budget_polls % kBudgetPollInterval == 0)
+        return ctx.budget->poll();
+    return ctx.budget->stopped();
+}
+
+bool propagate_queue(SolveContext &ctx, DomainGrid &g) {
+    auto &q = ctx.q;
+    auto &line_domains = ctx.line_domains;
+    auto &new_line_domains = ctx.new_line_domains;
+
+    while (!q.empty()) {
+        if (out_of_budget(ctx)) {
+            q.clear();
+            return false;
+        }
+        const auto cur = q.pop();
+
+        // Cell i of the line has the flat index first + i * step
+        const int len = cur.is_row ? g.C : g.R;
+        const int first = cur.is_row ? cur.idx * g.C : cur.idx;
+        const int step = cur.is_row ? 1 : g.C;
+        const LineAutomaton &automaton = cur.is_row ? ctx.lines.rows[cur.idx] : ctx.lines.cols[cur.idx];
+
+        bool determined = true;
+        line_domains.assign(len, 0);
+        g.read_line(cur.is_row, cur.idx, line_domains.data());
+        for (int i = 0; i < len && determined; ++i)
+            determined = popcount2(line_domains[i]) == 1;
+
+        // A fully determined line can't change any more, it only has to match its clue.
+        // Nothing can re-queue it below this node without a contradiction, so it is done for good.
+        if (determined) {
+            if (!automaton.accepts(line_domains)) {
+                q.clear();
+                return false;
+            }
+            continue;
+        }
+
+        ++(cur.is_row ? ctx.stats.row_propagations : ctx.stats.col_propagations);
+        if (!propagate_line_domains(automaton, line_domains, new_line_domains, ctx.scratch, ctx.kernel)) {
+            q.clear();
+            return false;
+        }
+
+        for (int i = 0; i < len; ++i) {
+            const std::uint8_t newv = new_line_domains[i];
+            if (newv != line_domains[i]) {
+                ctx.trail.set(g, first + i * step, newv);
+                ctx.q.push({!cur.is_row, i});
+            }
+        }
+    }
+
+    return true;
+}
+
+bool enforce_arc_consistency(SolveContext &ctx, DomainGrid &g) {
+    for (int r = 0; r < g.R; ++r)
+        ctx.q.push({true, r});
+    for (int c = 0; c < g.C; ++c)
+        ctx.q.push({false, c});
+
+    return propagate_queue(ctx, g);
+}
+
+bool assign_and_propagate(SolveContext &ctx, DomainGrid &g, int cell, std::uint8_t value) {
+    ctx.trail.set(g, cell, value);
+    ctx.q.push({true, cell / g.C});
+    ctx.q.push({false, cell % g.C});
+    return propagate_queue(ctx, g);
+}
+
+bool pick_branch_line(SolveContext &ctx, const DomainGrid &g, int cell, LineRef &out_line) {
+    double best = static_cast<double>(kMaxLinePlacements) + 1.0;
+    for (const LineRef line : {LineRef{true, cell / g.C}, LineRef{false, cell % g.C}}) {
+        ctx.line_domains.assign(line.is_row ? g.C : g.R, 0);
+        g.read_line(line.is_row, line.idx, ctx.line_domains.data());
+
+        const LineAutomaton &automaton = line.is_row ? ctx.lines.rows[line.idx] : ctx.lines.cols[line.idx];
+        if (!count_line_completions(automaton, ctx.line_domains, ctx.completions_filled, ctx.completions_empty, ctx.scratch))
+            continue;
+        const double total = ctx.completions_filled[0] + ctx.completions_empty[0];
+        if (total < best) {
+            best = total;
+            out_line = line;
+        }
+    }
+    return best <= static_cast<double>(kMaxLinePlacements);
+}
+
+bool assign_line_and_propagate(SolveContext &ctx, DomainGrid &g, LineRef line, const std::uint8_t *values) {
+    const int len = line.is_row ? g.C : g.R;
+    const int first = line.is_row ? line.idx * g.C : line.idx;
+    const int step = line.is_row ? 1 : g.C;
+
+    // The line itself is a valid completion, only the crossing lines need another look
+    for (int i = 0; i < len; ++i) {
+        const int cell = first + i * step;
+        if (g.get(cell) != values[i]) {
+            ctx.trail.set(g, cell, values[i]);
+            ctx.q.push({!line.is_row, i});
+        }
+    }
+    return propagate_queue(ctx, g);
+}
+
+int pick_branch_cell(const DomainGrid &g, int from) {
+    const size_t idx = g.cells.next_unknown(static_cast<size_t>(from));
+    return idx < static_cast<size_t>(g.R) * g.C ? static_cast<int>(idx) : -1;
+}
+
+namespace {
+
+// Opens a search frame for branch and tries its first value, returns whether g is still consistent
+bool open_branch(SolveContext &ctx, DomainGrid &g, const SearchHooks &hooks, const BranchDecision &branch) {
+    LineRef line;
+    if (hooks.mode == BranchMode::Lines && pick_branch_line(ctx, g, branch.cell, line)) {
+        const int len = line.is_row ? g.C : g.R;
+        ctx.line_domains.assign(len, 0);
+        g.read_line(line.is_row, line.idx, ctx.line_domains.data());
+
+        SearchFrame frame{ctx.trail.mark(), branch.cell, 0};
+        frame.line = line;
+        frame.begin = ctx.placements.size();
+        const LineAutomaton &automaton = line.is_row ? ctx.lines.rows[line.idx] : ctx.lines.cols[line.idx];
+        enumerate_line_completions(automaton, ctx.line_domains, ctx.placements, ctx.scratch);
+        frame.next = frame.begin + len;
+        frame.end = ctx.placements.size();
+
+        // Idle threads get every placement but the first
+        if (hooks.worker && hooks.worker->wants_work()) {
+            for (size_t p = frame.next; p < frame.end; p += len)
+                hooks.worker->donate_line(g, line, &ctx.placements[p]);
+            frame.next = frame.end;
+        }
+
+        ctx.stack.push_back(frame);
+        ctx.stats.max_depth = std::max(ctx.stats.max_depth, ctx.stack.size());
+        ++ctx.stats.nodes;
+        return assign_line_and_propagate(ctx, g, line, &ctx.placements[frame.begin]);
+    }
+
+    // An idle thread takes the second value as a snapshot instead of it waiting on this stack
+    std::uint8_t alternative = branch.second;
+    if (hooks.worker && hooks.worker->wants_work()) {
+        hooks.worker->donate(g, branch.cell, branch.second);
+        alternative = 0;
+    }
+
+    ctx.stack.push_back({ctx.trail.mark(), branch.cell, alternative});
+    ctx.stats.max_depth = std::max(ctx.stats.max_depth, ctx.stack.size());
+    ++ctx.stats.nodes;
+    return assign_and_propagate(ctx, g, branch.cell, branch.first);
+}
+
+} // namespace
+
+bool search_subtree(SolveContext &ctx, DomainGrid &g, const SearchHooks &hooks) {
+    ctx.stack.clear();
+    ctx.placements.clear();
+
+    bool consistent = true;
+    for (;;) {
+        if (hooks.worker && hooks.worker->should_stop())
+            return false;
+        if (out_of_budget(ctx))
+            return false;
+
+        if (consistent && hooks.prober)
+            consistent = hooks.prober->run(ctx, g);
+
+        if (consistent) {
+            const int from = ctx.stack.empty() ? 0 : ctx.stack.back().cell;
+            BranchDecision branch{pick_branch_cell(g, from), D_FILLED, D_EMPTY};
+            const bool solved = hooks.brancher ? !hooks.brancher->decide(ctx, g, from, branch) : branch.cell < 0;
+            if (!solved) {
+                consistent = open_branch(ctx, g, hooks, branch);
+                continue;
+            }
+
+            if (!hooks.on_solution || !hooks.on_solution(g))
+                return true;
+            // treat the solution like a dead end, backtracking moves on to the next one
+            consistent = false;
+        }
+
+        // Backtrack to the deepest frame that still has a value to try
+        if (!consistent)
+            ++ctx.stats.backtracks;
+        while (!ctx.stack.empty() && !consistent) {
+            SearchFrame &frame = ctx.stack.back();
+            ctx.trail.undo_to(g, frame.trail_mark);
+            if (frame.line.idx >= 0) {
+                if (frame.next == frame.end) {
+                    ctx.placements.resize(frame.begin);
+                    ctx.stack.pop_back();
+                    continue;
+                }
+
+                const size_t p = frame.next;
+                frame.next += frame.line.is_row ? g.C : g.R;
+                ++ctx.stats.nodes;
+                consistent = assign_line_and_propagate(ctx, g, frame.line, &ctx.placements[p]);
+                continue;
+            }
+            if (frame.alternative == 0) {
+                ctx.stack.pop_back();
+                continue;
+            }
+
+            const std::uint8_t value = frame.alternative;
+            frame.alternative = 0;
+            ++ctx.stats.nodes;
+            consistent = assign_and_propagate(ctx, g, frame.cell, value);
+        }
+        if (!consistent)
+            return false;
+    }
+}
@@ -1,431 +1,307 @@
 #include "../../include/solvers/DPSolver.h"
 
 #include "../../include/Cell.h"
+#include "../../include/core/AllocationCounter.h"
+#include "../../include/solvers/BranchHeuristic.h"
+#include "../../include/solvers/DPSearch.h"
+#include "../../include/solvers/DomainGrid.h"
+#include "../../include/solvers/FailedLiteralProber.h"
+#include "../../include/solvers/LineAutomaton.h"
+#include "../../include/solvers/WorkStealingSearch.h"
+
+#include "../../include/core/ThreadPool.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
-#include <deque>
+#include <memory>
 #include <string>
-#include <utility>
 #include <vector>
 
-namespace {
-
-// Domain bitmask per cell
-// bit0 (1) = Empty possible
-// bit1 (2) = Filled possible
-constexpr std::uint8_t D_EMPTY = 0x1;
-constexpr std::uint8_t D_FILLED = 0x2;
-
-inline std::uint8_t domain_from_cell(Cell c) {
-    switch (c) {
-    case Cell::Empty:
-        return D_EMPTY;
-    case Cell::Filled:
-        return D_FILLED;
-    case Cell::Unknown:
-    default:
-        return D_EMPTY | D_FILLED;
-    }
+void DPSolver::setLineKernel(LineKernel kernel) {
+    kernel_ = kernel;
 }
 
-inline Cell cell_from_domain(std::uint8_t d) {
-    if (d == D_EMPTY)
-        return Cell::Empty;
-    if (d == D_FILLED)
-        return Cell::Filled;
-    return Cell::Unknown;
+void DPSolver::setLineSchedule(LineSchedule schedule) {
+    schedule_ = schedule;
 }
 
-inline int popcount2(std::uint8_t d) {
-    // only need for {0..3}
-    return (d & 1 ? 1 : 0) + (d & 2 ? 1 : 0);
+void DPSolver::setThreadCount(int threads) {
+    threads_ = std::max(1, threads);
 }
 
-// Line automaton state:
-// j   = number of blocks already completed (0..M)
-// rem = remaining filled cells to place in current block (0..N)
-// sep = must place at least one empty before starting next block (only meaningful if rem==0 and j<M)
-struct State {
-    int j;
-    int rem;
-    int sep;
-};
-
-struct LineRef { bool is_row; int idx; };
-
-struct DomainGrid {
-    int R = 0;
-    int C = 0;
-    std::vector<std::uint8_t> d; // flattened R*C
-
-    std::uint8_t &at(int r, int c) { return d[r * C + c]; }
-    std::uint8_t at(int r, int c) const { return d[r * C + c]; }
-
-    bool all_singleton() const {
-        for (auto v : d) {
-            if (v != D_EMPTY && v != D_FILLED)
-                return false;
-        }
-        return true;
-    }
-};
-
-// Per-line propagation using reachability through a small automaton.
-// Returns false on contradiction (no valid completion), else true and fills out_new_domains.
-bool propagate_line_domains(const std::vector<int> &clues,
-                            const std::vector<std::uint8_t> &in_domains,
-                            std::vector<std::uint8_t> &out_new_domains) {
-    const int N = static_cast<int>(in_domains.size());
-    const int M = static_cast<int>(  clues.size()   );
-
-    if (N == 0) {
-        out_new_domains.clear();
-        return true;
-    }
+void DPSolver::setProbeMode(ProbeMode mode) {
+    probe_mode_ = mode;
+}
 
-    // Precompute mapping from (j, rem, sep) -> id.
-    // We keep the full rectangle for simplicity: id = ((j*(N+1) + rem)*2 + sep)
-    const int REM_MAX       = N;
-    const int STATE_COUNT   = (M + 1) * (REM_MAX + 1) * 2;
+void DPSolver::setBranchRule(BranchRule rule) {
+    branch_rule_ = rule;
+}
 
-    auto id_of = [REM_MAX](int j, int rem, int sep) -> int {
-        return ((j * (REM_MAX + 1) + rem) * 2 + sep);
-    };
+void DPSolver::setValueOrder(ValueOrder order) {
+    value_order_ = order;
+}
 
-    auto unpack = [REM_MAX](int id) -> State {
-        const int sep = id % 2;
-        id /= 2;
-        const int rem = id % (REM_MAX + 1);
-        const int j = id / (REM_MAX + 1);
-        return {j, rem, sep};
-    };
+void DPSolver::setBranchMode(BranchMode mode) {
+    branch_mode_ = mode;
+}
 
-    // Transitions for EMPTY and FILLED from any state id.
-    std::vector<int> trans_empty(STATE_COUNT, {-1});
-    std::vector<int> trans_filled(STATE_COUNT, {-1});
-
-    for (int id = 0; id < STATE_COUNT; ++id) {
-        const State s = unpack(id);
-        const int j = s.j;
-        const int rem = s.rem;
-        const bool sep = (s.sep != 0);
-
-        // EMPTY transition
-        if (rem == 0) {
-            // placing empty is always allowed when not in a block
-            // if sep was required, this empty satisfies it.
-            const int next_sep = 0;
-            trans_empty[id] = {id_of(j, 0, next_sep)};
-        } 
-
-        // FILLED transition
-        if (!sep) {
-            if (rem > 0) {
-                // continue current block
-                const int rem2 = rem - 1;
-                if (rem2 == 0) {
-                    // block completes now
-                    const int j2 = j + 1;
-                    if (j2 <= M) {
-                        const int sep2 = (j2 < M) ? 1 : 0;
-                        trans_filled[id] = {id_of(j2, 0, sep2)};
-                    }
-                } else {
-                    trans_filled[id] = {id_of(j, rem2, 0)};
-                }
-            } else {
-                // rem == 0, can start a new block if any left
-                if (j < M) {
-                    const int len = clues[j];
-                    if (len <= 0 || len > N) {
-                        // invalid clue
-                        return false;
-                    }
-                    if (len == 1) {
-                        const int j2 = j + 1;
-                        const int sep2 = (j2 < M) ? 1 : 0;
-                        trans_filled[id] = {id_of(j2, 0, sep2)};
-                    } else {
-                        // we place first filled now; remaining is len-1
-                        trans_filled[id] = {id_of(j, len - 1, 0)};
-                    }
-                }
-            }
-        }
-    }
+void DPSolver::setLimits(const SolveLimits &limits) {
+    limits_ = limits;
+}
 
-    auto is_accept = [M](const State &s) -> bool {
-        return (s.j == M) && (s.rem == 0);
-    };
+void DPSolver::setSharedBudget(SolveBudget *budget) {
+    shared_budget_ = budget;
+}
 
-    // Forward reachability: forward[i][state] = reachable after i cells
-    std::vector<std::vector<std::uint8_t>> forward(N + 1, std::vector<std::uint8_t>(STATE_COUNT, 0));
-    std::vector<std::vector<std::uint8_t>> backward(N + 1, std::vector<std::uint8_t>(STATE_COUNT, 0));
-
-    const int start = id_of(0, 0, 0);
-    forward[0][start] = 1;
-
-    for (int i = 0; i < N; ++i) {
-        const std::uint8_t dom = in_domains[i];
-        for (int sid = 0; sid < STATE_COUNT; ++sid) {
-            if (!forward[i][sid])
-                continue;
-
-            if (dom & D_EMPTY) {
-                const int nid = trans_empty[sid];
-                if (nid >= 0)
-                    forward[i + 1][nid] = 1;
-            }
-            if (dom & D_FILLED) {
-                const int nid = trans_filled[sid];
-                if (nid >= 0)
-                    forward[i + 1][nid] = 1;
-            }
-        }
-    }
+SolveStatus DPSolver::status() const {
+    return status_;
+}
 
-    // Backward reachability: backward[i][state] = can reach accept from here with remaining cells
-    for (int sid = 0; sid < STATE_COUNT; ++sid) {
-        const State s = unpack(sid);
-        if (is_accept(s))
-            backward[N][sid] = 1;
-    }
-    for (int i = N - 1; i >= 0; --i) {
-        const std::uint8_t dom = in_domains[i];
-        for (int sid = 0; sid < STATE_COUNT; ++sid) {
-            bool ok = false;
-            if (dom & D_EMPTY) {
-                const int nid = trans_empty[sid];
-                if (nid >= 0 && backward[i + 1][nid])
-                    ok = true;
-            }
-            if (!ok && (dom & D_FILLED)) {
-                const int nid = trans_filled[sid];
-                if (nid >= 0 && backward[i + 1][nid])
-                    ok = true;
-            }
-            backward[i][sid] = ok ? 1 : 0;
-        }
-    }
+SolveCutoff DPSolver::cutoff() const {
+    return cutoff_;
+}
 
-    // If no accepting path exists at all -> contradiction
-    bool any_path = false;
-    for (int sid = 0; sid < STATE_COUNT; ++sid) {
-        if (forward[N][sid] && backward[N][sid]) {
-            any_path = true;
-            break;
-        }
-    }
-    if (!any_path)
-        return false;
+const SolverStats &DPSolver::stats() const {
+    return stats_;
+}
 
-    // Per-position possibility marking via prefix/suffix connectivity
-    out_new_domains.assign(N, 0);
-    for (int i = 0; i < N; ++i) {
-        bool can_empty = false;
-        bool can_filled = false;
-
-        const std::uint8_t dom = in_domains[i];
-
-        for (int sid = 0; sid < STATE_COUNT; ++sid) {
-            if (!forward[i][sid])
-                continue;
-
-            if ((dom & D_EMPTY) && !can_empty) {
-                const int nid = trans_empty[sid];
-                if (nid >= 0 && backward[i + 1][nid])
-                    can_empty = true;
-            }
-            if ((dom & D_FILLED) && !can_filled) {
-                const int nid = trans_filled[sid];
-                if (nid >= 0 && backward[i + 1][nid])
-                    can_filled = true;
-            }
-            if (can_empty && can_filled)
-                break;
-        }
+std::size_t DPSolver::probeFixedCells() const {
+    return stats_.probe_fixed_cells;
+}
 
-        std::uint8_t nd = 0;
-        if (can_empty)
-            nd |= D_EMPTY;
-        if (can_filled)
-            nd |= D_FILLED;
-        out_new_domains[i] = nd;
-        if (nd == 0)
-            return false;
-    }
+std::size_t DPSolver::linePropagations() const {
+    return stats_.line_propagations();
+}
 
-    return true;
+std::size_t DPSolver::searchNodes() const {
+    return stats_.nodes;
 }
 
+std::size_t DPSolver::searchAllocations() const {
+    return search_allocations_;
+}
 
-bool enforce_arc_consistency(const Nonogram &puz, DomainGrid &g) {
-    std::deque<LineRef> q;
-    std::vector<std::uint8_t> inQ_row(g.R, 0), inQ_col(g.C, 0);
+namespace {
 
-    for (int r = 0; r < g.R; ++r) {
-        q.push_back({true, r});
-        inQ_row[r] = 1;
+bool check_grid(const Nonogram &puzzle, const DomainGrid &g, std::string &error) {
+    if (puzzle.rows() == 0 || puzzle.cols() == 0) {
+        error = "DPSolver: puzzle has zero size";
+        return false;
     }
-    for (int c = 0; c < g.C; ++c) {
-        q.push_back({false, c});
-        inQ_col[c] = 1;
+    if (static_cast<size_t>(g.R) != puzzle.rows() || static_cast<size_t>(g.C) != puzzle.cols() ||
+        g.cells.rows() != puzzle.rows() || g.cells.cols() != puzzle.cols()) {
+        error = "DPSolver: domain grid doesn't match the puzzle size";
+        return false;
     }
+    return true;
+}
 
-    std::vector<std::uint8_t> line_domains;
-    std::vector<std::uint8_t> new_line_domains;
-
-    while (!q.empty()) {
-        const auto cur = q.front();
-        q.pop_front();
-        if (cur.is_row)
-            inQ_row[cur.idx] = 0;
-        else
-            inQ_col[cur.idx] = 0;
-
-        if (cur.is_row) {
-            const int r = cur.idx;
-            line_domains.assign(g.C, 0);
-            for (int c = 0; c < g.C; ++c)
-                line_domains[c] = g.at(r, c);
-
-            if (!propagate_line_domains(puz.row_clues[r], line_domains, new_line_domains))
-                return false;
-
-            for (int c = 0; c < g.C; ++c) {
-                const std::uint8_t oldv = g.at(r, c);
-                const std::uint8_t newv = new_line_domains[c];
-                if (newv == 0)
-                    return false;
-                if (newv != oldv) {
-                    g.at(r, c) = newv;
-                    if (!inQ_col[c]) {
-                        q.push_back({false, c});
-                        inQ_col[c] = 1;
-                    }
-                }
-            }
-        } else {
-            const int c = cur.idx;
-            line_domains.assign(g.R, 0);
-            for (int r = 0; r < g.R; ++r)
-                line_domains[r] = g.at(r, c);
-
-            if (!propagate_line_domains(puz.col_clues[c], line_domains, new_line_domains))
-                return false;
-
-            for (int r = 0; r < g.R; ++r) {
-                const std::uint8_t oldv = g.at(r, c);
-                const std::uint8_t newv = new_line_domains[r];
-                if (newv == 0)
-                    return false;
-                if (newv != oldv) {
-                    g.at(r, c) = newv;
-                    if (!inQ_row[r]) {
-                        q.push_back({true, r});
-                        inQ_row[r] = 1;
-                    }
-                }
-            }
-        }
+// If user forgot to resize cells, fix it.
+void fit_cells(Nonogram &puzzle) {
+    if (puzzle.cells.rows() != puzzle.rows() || puzzle.cells.cols() != puzzle.cols()) {
+        puzzle.resize_from_clues();
     }
+}
 
-    return true;
+} // namespace
+
+bool DPSolver::solve(Nonogram &puzzle, std::string &error) {
+    fit_cells(puzzle);
+    DomainGrid g = domains_from_cells(puzzle);
+    const bool solved = solve(puzzle, g, error);
+    if (status_ == SolveStatus::Solved || status_ == SolveStatus::TimedOut)
+        write_cells(g, puzzle);
+    return solved;
 }
 
-bool dfs_solve(const Nonogram &puz, DomainGrid &g) {
-    if (!enforce_arc_consistency(puz, g))
+bool DPSolver::solve(const Nonogram &puzzle, DomainGrid &g, std::string &error, bool at_fixpoint) {
+    bool found = false;
+    if (!search(puzzle, g, nullptr, at_fixpoint, found, error))
         return false;
-    if (g.all_singleton())
-        return true;
-
-    // Pick the most constrained unknown cell
-    int best_r = -1, best_c = -1;
-    int best_size = 3;
-
-    for (int r = 0; r < g.R; ++r) {
-        for (int c = 0; c < g.C; ++c) {
-            const std::uint8_t v = g.at(r, c);
-            const int pc = popcount2(v);
-            if (pc == 0)
-                return false;
-            if (pc > 1 && pc < best_size) {
-                best_size = pc;
-                best_r = r;
-                best_c = c;
-                if (best_size == 2)
-                    goto chosen;
-            }
-        }
-    }
 
-chosen:
-    if (best_r < 0)
+    if (status_ == SolveStatus::TimedOut) {
+        error = "DPSolver: stopped early (" + std::string(solve_cutoff_name(cutoff_)) + ")";
         return false;
+    }
+    if (!found) {
+        error = "DPSolver: puzzle is unsatisfiable (no solution found)";
+        return false;
+    }
+    return true;
+}
 
-    const std::uint8_t v = g.at(best_r, best_c);
+bool DPSolver::countSolutions(Nonogram &puzzle, int limit, SolutionCount &out, std::string &error) {
+    fit_cells(puzzle);
+    DomainGrid g = domains_from_cells(puzzle);
+    const bool ok = countSolutions(puzzle, g, limit, out, error);
+    if (out.solutions > 0 || status_ == SolveStatus::TimedOut)
+        write_cells(g, puzzle);
+    return ok;
+}
 
-    // Try Filled first (often helps), then Empty
-    if (v & D_FILLED) {
-        DomainGrid g2 = g;
-        g2.at(best_r, best_c) = D_FILLED;
-        if (dfs_solve(puz, g2)) {
-            g = std::move(g2);
-            return true;
-        }
+bool DPSolver::countSolutions(const Nonogram &puzzle, DomainGrid &g, int limit, SolutionCount &out, std::string &error,
+                              bool at_fixpoint) {
+    out = SolutionCount{};
+    out.limit = limit;
+    if (limit < 1) {
+        status_ = SolveStatus::Failed;
+        error = "DPSolver: solution limit must be at least 1";
+        return false;
     }
-    if (v & D_EMPTY) {
-        DomainGrid g2 = g;
-        g2.at(best_r, best_c) = D_EMPTY;
-        if (dfs_solve(puz, g2)) {
-            g = std::move(g2);
-            return true;
-        }
+
+    bool found = false;
+    if (!search(puzzle, g, &out, at_fixpoint, found, error))
+        return false;
+    if (status_ == SolveStatus::TimedOut) {
+        error = "DPSolver: stopped early (" + std::string(solve_cutoff_name(cutoff_)) + ")";
+        return false;
     }
+    return true;
+}
 
-    return false;
+const PuzzleAutomata &DPSolver::automata_for(const Nonogram &puzzle) {
+    if (has_automata_ && automata_row_clues_ == puzzle.row_clues && automata_col_clues_ == puzzle.col_clues)
+        return automata_;
+    automata_ = compile_automata(puzzle);
+    automata_row_clues_ = puzzle.row_clues;
+    automata_col_clues_ = puzzle.col_clues;
+    has_automata_ = true;
+    return automata_;
 }
 
-} // namespace
+LineResult DPSolver::propagate(const Nonogram &puzzle, DomainGrid &g, std::string &error) {
+    error.clear();
+    stats_ = SolverStats{};
+    if (!check_grid(puzzle, g, error))
+        return LineResult::Contradiction;
+
+    const PuzzleAutomata &lines = automata_for(puzzle);
+    SolveBudget own_budget(limits_);
+    SolveContext ctx(lines, kernel_, schedule_, g.R, g.C);
+    ctx.budget = shared_budget_ ? shared_budget_ : limits_.limited() ? &own_budget : nullptr;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool consistent = enforce_arc_consistency(ctx, g);
+    stats_.arc_consistency_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    stats_.add(ctx.totals());
+    stats_.root_fixed_cells = ctx.trail.mark();
+
+    // Cut short the cells written so far are still proved, the caller sees the stop on the budget
+    if (!consistent && !(ctx.budget && ctx.budget->stopped())) {
+        error = "DPSolver: contradiction in line propagation";
+        return LineResult::Contradiction;
+    }
+    return ctx.trail.mark() > 0 ? LineResult::Changed : LineResult::NoChange;
+}
 
-bool DPSolver::solve(Nonogram &puzzle, std::string &error) {
+bool DPSolver::search(const Nonogram &puzzle, DomainGrid &g, SolutionCount *count, bool at_fixpoint, bool &found,
+                      std::string &error) {
     error.clear();
+    found = false;
+    stats_ = SolverStats{};
+    status_ = SolveStatus::Failed;
+    cutoff_ = SolveCutoff::None;
 
-    if (puzzle.rows() == 0 || puzzle.cols() == 0) {
-        error = "DPSolver: puzzle has zero size";
+    if (!check_grid(puzzle, g, error))
         return false;
-    }
 
-    // If user forgot to resize cells, fix it.
-    if (puzzle.cells.size() != puzzle.rows() ||
-        (!puzzle.cells.empty() && puzzle.cells[0].size() != puzzle.cols())) {
-        puzzle.resize_from_clues();
-    }
+    // Each clue is compiled once per puzzle and shared by every propagation in the search
+    const PuzzleAutomata &lines = automata_for(puzzle);
 
-    DomainGrid g;
-    g.R = static_cast<int>(puzzle.rows());
-    g.C = static_cast<int>(puzzle.cols());
-    g.d.assign(g.R * g.C, D_EMPTY | D_FILLED);
+    // Extra threads go to the probes when probing runs at every node, otherwise to the search.
+    // Counting walks every solution in order, so it keeps the search on one thread.
+    const bool parallel_search = threads_ > 1 && probe_mode_ != ProbeMode::EveryNode && !count;
 
-    for (int r = 0; r < g.R; ++r) {
-        for (int c = 0; c < g.C; ++c) {
-            g.at(r, c) = domain_from_cell(puzzle.cells[r][c]);
-        }
+    std::unique_ptr<nonogram::core::ThreadPool> pool;
+    std::unique_ptr<FailedLiteralProber> prober;
+    if (probe_mode_ != ProbeMode::Off) {
+        if (threads_ > 1)
+            pool = std::make_unique<nonogram::core::ThreadPool>(threads_);
+        prober = std::make_unique<FailedLiteralProber>(lines, kernel_, schedule_, g.R, g.C, pool.get());
     }
 
+    // The clock starts before the root propagation, which is the first thing that can take long
+    SolveBudget own_budget(limits_);
+    SolveBudget *limits = shared_budget_ ? shared_budget_ : limits_.limited() ? &own_budget : nullptr;
+    if (prober)
+        prober->set_budget(limits);
+
+    SolveContext ctx(lines, kernel_, schedule_, g.R, g.C);
+    ctx.budget = limits;
+    const auto brancher = make_branch_heuristic(branch_rule_, value_order_, g.R, g.C);
     DomainGrid solved = g;
-    if (!dfs_solve(puzzle, solved)) {
-        error = "DPSolver: puzzle is unsatisfiable (no solution found)";
-        return false;
-    }
 
-    // Write back solution
-    for (int r = 0; r < g.R; ++r) {
-        for (int c = 0; c < g.C; ++c) {
-            puzzle.cells[r][c] = cell_from_domain(solved.at(r, c));
+    // Counting keeps the first solution and continues from each leaf until the limit is hit
+    DomainGrid first_solution;
+    auto on_solution = [&](const DomainGrid &leaf) {
+        if (++count->solutions == 1) {
+            first_solution = leaf;
+        } else if (count->solutions == 2) {
+            for (int r = 0; r < leaf.R; ++r)
+                for (int c = 0; c < leaf.C; ++c)
+                    if (leaf.at(r, c) != first_solution.at(r, c))
+                        count->distinguishing_cells.push_back({r, c});
         }
-    }
+        return count->solutions < count->limit;
+    };
 
+    const std::size_t allocations_before = nonogram::core::allocation_count();
+    const auto t0 = std::chrono::steady_clock::now();
+    found = at_fixpoint || enforce_arc_consistency(ctx, solved);
+    const auto t1 = std::chrono::steady_clock::now();
+    // the trail starts empty, so everything on it now was fixed by the root propagation
+    stats_.root_fixed_cells = ctx.trail.mark();
+    if (found && probe_mode_ == ProbeMode::Root)
+        found = prober->run(ctx, solved);
+
+    // What a stopped solve hands back: every cell here was proved, nothing guessed yet.
+    // Propagation cut short halfway is still only proved cells, so this holds if the budget ran out already.
+    DomainGrid proved;
+    if (limits)
+        proved = solved;
+
+    if (found && parallel_search) {
+        found = work_stealing_search(lines, kernel_, schedule_, branch_rule_, value_order_, branch_mode_, solved, threads_,
+                                     limits, stats_);
+    } else if (found) {
+        SearchHooks hooks;
+        hooks.brancher = brancher.get();
+        hooks.mode = branch_mode_;
+        if (probe_mode_ == ProbeMode::EveryNode)
+            hooks.prober = prober.get();
+        if (count)
+            hooks.on_solution = on_solution;
+        found = search_subtree(ctx, solved, hooks);
+    }
+    search_allocations_ = parallel_search ? 0 : nonogram::core::allocation_count() - allocations_before;
+    stats_.arc_consistency_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+    stats_.search_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t1).count();
+
+    stats_.add(ctx.totals());
+    if (prober)
+        stats_.add(prober->stats());
+
+    // A solution found before the budget ran out still counts, a count stopped early isn't exhausted
+    const bool stopped = limits && limits->stopped() && (count || !found);
+    if (count) {
+        count->exhausted = !found && !stopped;
+        found = count->solutions > 0;
+        if (found)
+            solved.swap(first_solution);
+    }
+    if (stopped) {
+        status_ = SolveStatus::TimedOut;
+        cutoff_ = limits->cutoff();
+        if (!found) {
+            solved.swap(proved);
+            found = true; // writes the proved cells back below
+        }
+    } else {
+        status_ = found ? SolveStatus::Solved : SolveStatus::NoSolution;
+    }
+    // the solution, or the proved cells of a stopped solve
+    if (found)
+        g.swap(solved);
     return true;
 }
@@ -0,0 +1,150 @@
+#include "../../include/solvers/FailedLiteralProber.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+const char *probe_mode_name(ProbeMode mode) {
+    switch (mode) {
+    case ProbeMode::Off:
+        return "off";
+    case ProbeMode::Root:
+        return "root";
+    case ProbeMode::EveryNode:
+        return "every-node";
+    default:
+        return "unknown";
+    }
+}
+
+FailedLiteralProber::FailedLiteralProber(const PuzzleAutomata &lines, LineKernel kernel, LineSchedule schedule,
+                                         int R, int C, nonogram::core::ThreadPool *pool)
+    : pool_(pool) {
+    const int threads = pool ? pool->size() : 1;
+    for (int i = 0; i < threads; ++i) {
+        auto w = std::make_unique<ProbeWorker>(lines, kernel, schedule, R, C);
+        w->g.resize(R, C);
+        w->stamp.assign(static_cast<size_t>(R) * C, 0);
+        w->seen_value.assign(static_cast<size_t>(R) * C, 0);
+        w->implied.reserve(static_cast<size_t>(R) * C);
+        workers_.push_back(std::move(w));
+    }
+    unknown_.reserve(static_cast<size_t>(R) * C);
+}
+
+SolverStats FailedLiteralProber::stats() const {
+    SolverStats total;
+    for (const auto &w : workers_)
+        total.add(w->ctx.totals());
+    total.probe_fixed_cells = fixed_cells_;
+    return total;
+}
+
+void FailedLiteralProber::set_budget(SolveBudget *budget) {
+    budget_ = budget;
+    for (auto &w : workers_)
+        w->ctx.budget = budget;
+}
+
+void FailedLiteralProber::probe_cell(ProbeWorker &w, int cell) {
+    // another probe of this round already proved the base grid unsolvable
+    if (w.contradiction)
+        return;
+
+    const size_t mark = w.ctx.trail.mark();
+    ++w.probe_id;
+
+    // Filled probe, remember what it fixed
+    const bool filled_ok = assign_and_propagate(w.ctx, w.g, cell, D_FILLED);
+    if (filled_ok) {
+        for (size_t i = mark; i < w.ctx.trail.mark(); ++i) {
+            const int idx = w.ctx.trail.index_at(i);
+            w.stamp[idx] = w.probe_id;
+            w.seen_value[idx] = w.g.get(idx);
+        }
+    }
+    w.ctx.trail.undo_to(w.g, mark);
+
+    // Empty probe, cells it fixes the same way as the Filled probe are implied either way
+    const bool empty_ok = assign_and_propagate(w.ctx, w.g, cell, D_EMPTY);
+    if (filled_ok && empty_ok) {
+        for (size_t i = mark; i < w.ctx.trail.mark(); ++i) {
+            const int idx = w.ctx.trail.index_at(i);
+            if (idx != cell && w.stamp[idx] == w.probe_id && w.seen_value[idx] == w.g.get(idx))
+                w.implied.push_back({idx, w.g.get(idx)});
+        }
+    } else if (empty_ok) {
+        // Filled failed, so the cell is Empty along with everything Empty implies
+        for (size_t i = mark; i < w.ctx.trail.mark(); ++i) {
+            const int idx = w.ctx.trail.index_at(i);
+            w.implied.push_back({idx, w.g.get(idx)});
+        }
+    }
+    w.ctx.trail.undo_to(w.g, mark);
+
+    if (filled_ok && !empty_ok) {
+        // Empty failed, redo the Filled probe to collect its consequences
+        assign_and_propagate(w.ctx, w.g, cell, D_FILLED);
+        for (size_t i = mark; i < w.ctx.trail.mark(); ++i) {
+            const int idx = w.ctx.trail.index_at(i);
+            w.implied.push_back({idx, w.g.get(idx)});
+        }
+        w.ctx.trail.undo_to(w.g, mark);
+    }
+
+    if (!filled_ok && !empty_ok)
+        w.contradiction = true;
+}
+
+bool FailedLiteralProber::run(SolveContext &ctx, DomainGrid &g) {
+    for (;;) {
+        unknown_.clear();
+        const size_t total = static_cast<size_t>(g.R) * g.C;
+        for (size_t idx = g.cells.next_unknown(0); idx < total; idx = g.cells.next_unknown(idx + 1))
+            unknown_.push_back(static_cast<int>(idx));
+        if (unknown_.empty())
+            return true;
+
+        for (auto &w : workers_) {
+            w->g.cells = g.cells;
+            w->ctx.trail.clear();
+            w->implied.clear();
+            w->contradiction = false;
+        }
+
+        auto job = [this](int worker, size_t i) { probe_cell(*workers_[worker], unknown_[i]); };
+        if (pool_)
+            pool_->run(unknown_.size(), job);
+        else
+            for (size_t i = 0; i < unknown_.size(); ++i)
+                job(0, i);
+        probes_ += unknown_.size() * 2;
+        // a probe cut short by the budget looks like a failed one, so nothing it found can be used
+        if (budget_ && budget_->stopped())
+            return false;
+
+        // Every implied value holds in all solutions below g, so they can all be applied together
+        size_t learned = 0;
+        for (auto &w : workers_) {
+            if (w->contradiction)
+                return false;
+            for (const auto &[idx, value] : w->implied) {
+                const std::uint8_t current = g.get(idx);
+                if (current == value)
+                    continue;
+                if (popcount2(current) == 1)
+                    return false; // two probes proved opposite values
+                ctx.trail.set(g, idx, value);
+                ctx.q.push({true, idx / g.C});
+                ctx.q.push({false, idx % g.C});
+                ++learned;
+            }
+        }
+        fixed_cells_ += learned;
+
+        if (learned == 0)
+            return true;
+        if (!propagate_queue(ctx, g))
+            return false;
+    }
+}
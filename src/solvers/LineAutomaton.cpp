@@ -0,0 +1,456 @@
+#include "../../include/solvers/LineAutomaton.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+LineAutomaton::LineAutomaton(const std::vector<int> &clues) {
+    for (size_t j = 0; j < clues.size(); ++j) {
+        if (clues[j] <= 0) {
+            // invalid clue, every propagation will report a contradiction
+            valid_ = false;
+            return;
+        }
+        symbol_.insert(symbol_.end(), clues[j], D_FILLED);
+        if (j + 1 < clues.size())
+            symbol_.push_back(D_EMPTY);
+    }
+
+    // Empty can repeat before the first block, after a separator and after the last block
+    gap_.assign(symbol_.size() + 1, 0);
+    gap_[0] = 1;
+    gap_[symbol_.size()] = 1;
+    for (size_t k = 1; k < symbol_.size(); ++k)
+        if (symbol_[k - 1] == D_EMPTY)
+            gap_[k] = 1;
+
+    const size_t words = (gap_.size() + 63) / 64;
+    fill_mask_.assign(words, 0);
+    empty_mask_.assign(words, 0);
+    gap_mask_.assign(words, 0);
+    for (size_t k = 0; k < gap_.size(); ++k) {
+        const std::uint64_t bit = std::uint64_t{1} << (k % 64);
+        if (k < symbol_.size())
+            (symbol_[k] == D_FILLED ? fill_mask_ : empty_mask_)[k / 64] |= bit;
+        if (gap_[k])
+            gap_mask_[k / 64] |= bit;
+    }
+}
+
+bool LineAutomaton::accepts(const std::vector<std::uint8_t> &values) const {
+    if (!valid_)
+        return false;
+
+    int k = 0;
+    for (const std::uint8_t value : values) {
+        k = next(k, value);
+        if (k < 0)
+            return false;
+    }
+    return k == length();
+}
+
+PuzzleAutomata compile_automata(const Nonogram &puzzle) {
+    PuzzleAutomata automata;
+    automata.rows.reserve(puzzle.rows());
+    automata.cols.reserve(puzzle.cols());
+    for (const auto &clues : puzzle.row_clues)
+        automata.rows.emplace_back(clues);
+    for (const auto &clues : puzzle.col_clues)
+        automata.cols.emplace_back(clues);
+    return automata;
+}
+
+namespace {
+
+// Table sizes for one line of length N, shared by reserve() and the kernels
+size_t state_window(const LineAutomaton &automaton, int N) {
+    return static_cast<size_t>(std::min(N - automaton.length(), automaton.length()) + 1);
+}
+size_t word_window(const LineAutomaton &automaton, int N) {
+    return static_cast<size_t>((std::min(N - automaton.length(), automaton.length()) + 63) / 64 + 2);
+}
+
+void reserve_for_lines(LineScratch &scratch, const std::vector<LineAutomaton> &lines, int N) {
+    for (const auto &automaton : lines) {
+        if (!automaton.valid() || automaton.length() > N)
+            continue;
+        const size_t W = state_window(automaton, N);
+        const size_t WW = word_window(automaton, N);
+        const size_t words = static_cast<size_t>(automaton.word_count());
+
+        scratch.forward.reserve(std::max(scratch.forward.capacity(), (N + 1) * W));
+        scratch.backward_cur.reserve(std::max(scratch.backward_cur.capacity(), W));
+        scratch.backward_next.reserve(std::max(scratch.backward_next.capacity(), W));
+        scratch.forward_counts.reserve(std::max(scratch.forward_counts.capacity(), (N + 1) * W));
+        scratch.backward_cur_counts.reserve(std::max(scratch.backward_cur_counts.capacity(), W));
+        scratch.backward_next_counts.reserve(std::max(scratch.backward_next_counts.capacity(), W));
+        if (scratch.forward_words.size() < (N + 1) * WW)
+            scratch.forward_words.resize((N + 1) * WW);
+        if (scratch.backward_cur_words.size() < words) {
+            scratch.backward_cur_words.resize(words);
+            scratch.backward_next_words.resize(words);
+        }
+    }
+}
+
+// Depth-first walk of the accepting paths for enumerate_line_completions.
+// The completion being built is the last block of out, a finished one is copied
+// into a fresh block so the walk can keep its prefix.
+struct CompletionWalk {
+    const LineAutomaton &automaton;
+    const std::vector<std::uint8_t> &in_domains;
+    std::vector<std::uint8_t> &out;
+    const std::vector<std::uint8_t> &finish; // finish[i * W + k - lo(i)] = accept reachable from state k at cell i
+    int N;
+    int slack;
+    int W;
+    size_t count = 0;
+
+    int lo(int i) const { return std::max(0, i - slack); }
+    int hi(int i) const { return std::min(i, automaton.length()); }
+    bool can_finish(int i, int k) const {
+        return k >= lo(i) && k <= hi(i) && finish[static_cast<size_t>(i) * W + (k - lo(i))];
+    }
+
+    void walk(int i, int k) {
+        if (i == N) {
+            ++count;
+            out.insert(out.end(), out.end() - N, out.end());
+            return;
+        }
+        for (const std::uint8_t value : {D_EMPTY, D_FILLED}) {
+            if (!(in_domains[i] & value))
+                continue;
+            const int nk = automaton.next(k, value);
+            if (nk < 0 || !can_finish(i + 1, nk))
+                continue;
+            out[out.size() - N + i] = value;
+            walk(i + 1, nk);
+        }
+    }
+};
+
+// Slack = how far the tightest packing can slide. After i cells only states
+// max(0, i - slack) .. min(i, L) can still lead to acceptance, so each position
+// keeps a window of at most min(slack, L) + 1 states instead of the whole automaton.
+bool propagate_scalar(const LineAutomaton &automaton,
+                      const std::vector<std::uint8_t> &in_domains,
+                      std::vector<std::uint8_t> &out_new_domains,
+                      LineScratch &scratch) {
+    const int N = static_cast<int>(in_domains.size());
+    const int L = automaton.length();
+    const int slack = N - L;
+
+    const int W = static_cast<int>(state_window(automaton, N));
+    auto lo = [slack](int i) { return std::max(0, i - slack); };
+    auto hi = [L](int i) { return std::min(i, L); };
+    auto in_window = [&](int i, int k) { return k >= lo(i) && k <= hi(i); };
+
+    // Forward reachability: forward[i][k] = state k reachable after i cells
+    std::vector<std::uint8_t> &forward = scratch.forward;
+    forward.assign(static_cast<size_t>(N + 1) * W, 0);
+    auto fwd = [&](int i, int k) -> std::uint8_t & { return forward[static_cast<size_t>(i) * W + (k - lo(i))]; };
+
+    fwd(0, 0) = 1;
+    for (int i = 0; i < N; ++i) {
+        const std::uint8_t dom = in_domains[i];
+        for (int k = lo(i); k <= hi(i); ++k) {
+            if (!fwd(i, k))
+                continue;
+
+            if (dom & D_EMPTY) {
+                const int nk = automaton.next(k, D_EMPTY);
+                if (nk >= 0 && in_window(i + 1, nk))
+                    fwd(i + 1, nk) = 1;
+            }
+            if (dom & D_FILLED) {
+                const int nk = automaton.next(k, D_FILLED);
+                if (nk >= 0 && in_window(i + 1, nk))
+                    fwd(i + 1, nk) = 1;
+            }
+        }
+    }
+
+    // If no accepting path exists at all -> contradiction
+    if (!fwd(N, L))
+        return false;
+
+    // Backward reachability is only needed one position at a time, so it rolls over two windows.
+    // backward_next[k - lo(i + 1)] = can reach accept from state k with cells i+1..N-1
+    std::vector<std::uint8_t> &backward_next = scratch.backward_next;
+    std::vector<std::uint8_t> &backward_cur = scratch.backward_cur;
+    backward_next.assign(W, 0);
+    backward_cur.assign(W, 0);
+    backward_next[L - lo(N)] = 1;
+
+    auto can_finish = [&](int i, int nk) { return nk >= 0 && in_window(i + 1, nk) && backward_next[nk - lo(i + 1)]; };
+
+    out_new_domains.assign(N, 0);
+    for (int i = N - 1; i >= 0; --i) {
+        const std::uint8_t dom = in_domains[i];
+        bool can_empty = false;
+        bool can_filled = false;
+
+        std::fill(backward_cur.begin(), backward_cur.end(), 0);
+        for (int k = lo(i); k <= hi(i); ++k) {
+            const bool via_empty = (dom & D_EMPTY) && can_finish(i, automaton.next(k, D_EMPTY));
+            const bool via_filled = (dom & D_FILLED) && can_finish(i, automaton.next(k, D_FILLED));
+            backward_cur[k - lo(i)] = (via_empty || via_filled) ? 1 : 0;
+
+            // Per-position possibility marking via prefix/suffix connectivity
+            if (fwd(i, k)) {
+                can_empty = can_empty || via_empty;
+                can_filled = can_filled || via_filled;
+            }
+        }
+
+        std::uint8_t nd = 0;
+        if (can_empty)
+            nd |= D_EMPTY;
+        if (can_filled)
+            nd |= D_FILLED;
+        out_new_domains[i] = nd;
+        if (nd == 0)
+            return false;
+
+        std::swap(backward_cur, backward_next);
+    }
+
+    return true;
+}
+
+// Same sweeps as propagate_scalar, with the state set of a position packed into 64-bit words.
+// Each automaton state has one successor per value, so a whole word of states advances with
+// one shift and mask per value instead of one branch per state.
+bool propagate_bit_parallel(const LineAutomaton &automaton,
+                            const std::vector<std::uint8_t> &in_domains,
+                            std::vector<std::uint8_t> &out_new_domains,
+                            LineScratch &scratch) {
+    const int N = static_cast<int>(in_domains.size());
+    const int L = automaton.length();
+    const int slack = N - L;
+
+    const std::uint64_t *fill = automaton.fill_mask();
+    const std::uint64_t *empty = automaton.empty_mask();
+    const std::uint64_t *gap = automaton.gap_mask();
+
+    // Same state window as the scalar kernel, rounded out to whole words
+    auto wlo = [slack](int i) { return std::max(0, i - slack) / 64; };
+    auto whi = [L](int i) { return std::min(i, L) / 64; };
+    const int WW = static_cast<int>(word_window(automaton, N));
+
+    // Only window words are ever read back and every one of them is written first, so no clearing needed
+    std::vector<std::uint64_t> &forward = scratch.forward_words;
+    if (forward.size() < static_cast<size_t>(N + 1) * WW)
+        forward.resize(static_cast<size_t>(N + 1) * WW);
+    auto fwd = [&](int i, int w) -> std::uint64_t {
+        if (w < wlo(i) || w > whi(i))
+            return 0;
+        return forward[static_cast<size_t>(i) * WW + (w - wlo(i))];
+    };
+
+    forward[0] = 1; // state 0 after 0 cells
+    for (int i = 0; i < N; ++i) {
+        const std::uint8_t dom = in_domains[i];
+        std::uint64_t *out = &forward[static_cast<size_t>(i + 1) * WW];
+        for (int w = wlo(i + 1); w <= whi(i + 1); ++w) {
+            const std::uint64_t cur = fwd(i, w);
+            const std::uint64_t below = w > 0 ? fwd(i, w - 1) : 0;
+            std::uint64_t next = 0;
+            if (dom & D_FILLED)
+                next |= ((cur & fill[w]) << 1) | (w > 0 ? (below & fill[w - 1]) >> 63 : 0);
+            if (dom & D_EMPTY)
+                next |= ((cur & empty[w]) << 1) | (w > 0 ? (below & empty[w - 1]) >> 63 : 0) | (cur & gap[w]);
+            out[w - wlo(i + 1)] = next;
+        }
+    }
+
+    // If no accepting path exists at all -> contradiction
+    if (!((fwd(N, L / 64) >> (L % 64)) & 1))
+        return false;
+
+    // Rolling backward sets, indexed by absolute word, only the window words of a position are valid
+    const size_t words = static_cast<size_t>(automaton.word_count());
+    std::vector<std::uint64_t> &backward_next = scratch.backward_next_words;
+    std::vector<std::uint64_t> &backward_cur = scratch.backward_cur_words;
+    if (backward_next.size() < words) {
+        backward_next.resize(words);
+        backward_cur.resize(words);
+    }
+    backward_next[L / 64] = std::uint64_t{1} << (L % 64);
+
+    out_new_domains.assign(N, 0);
+    for (int i = N - 1; i >= 0; --i) {
+        const std::uint8_t dom = in_domains[i];
+        auto bwd = [&](int w) -> std::uint64_t {
+            return (w < wlo(i + 1) || w > whi(i + 1)) ? 0 : backward_next[w];
+        };
+
+        std::uint64_t can_empty = 0;
+        std::uint64_t can_filled = 0;
+        for (int w = wlo(i); w <= whi(i); ++w) {
+            const std::uint64_t succ = bwd(w);
+            const std::uint64_t succ_up = (succ >> 1) | (bwd(w + 1) << 63); // bit k = state k+1 finishes
+
+            const std::uint64_t via_filled = (dom & D_FILLED) ? (fill[w] & succ_up) : 0;
+            const std::uint64_t via_empty = (dom & D_EMPTY) ? ((empty[w] & succ_up) | (gap[w] & succ)) : 0;
+            backward_cur[w] = via_filled | via_empty;
+
+            // Per-position possibility marking via prefix/suffix connectivity
+            const std::uint64_t reach = fwd(i, w);
+            can_filled |= reach & via_filled;
+            can_empty |= reach & via_empty;
+        }
+
+        std::uint8_t nd = 0;
+        if (can_empty)
+            nd |= D_EMPTY;
+        if (can_filled)
+            nd |= D_FILLED;
+        out_new_domains[i] = nd;
+        if (nd == 0)
+            return false;
+
+        std::swap(backward_cur, backward_next);
+    }
+
+    return true;
+}
+
+} // namespace
+
+void LineScratch::reserve(const PuzzleAutomata &automata) {
+    const int rows = static_cast<int>(automata.rows.size());
+    const int cols = static_cast<int>(automata.cols.size());
+    reserve_for_lines(*this, automata.rows, cols);
+    reserve_for_lines(*this, automata.cols, rows);
+}
+
+bool propagate_line_domains(const LineAutomaton &automaton,
+                            const std::vector<std::uint8_t> &in_domains,
+                            std::vector<std::uint8_t> &out_new_domains,
+                            LineScratch &scratch,
+                            LineKernel kernel) {
+    const int N = static_cast<int>(in_domains.size());
+
+    if (N == 0) {
+        out_new_domains.clear();
+        return true;
+    }
+    if (!automaton.valid() || automaton.length() > N)
+        return false;
+
+    if (kernel == LineKernel::Scalar)
+        return propagate_scalar(automaton, in_domains, out_new_domains, scratch);
+    return propagate_bit_parallel(automaton, in_domains, out_new_domains, scratch);
+}
+
+bool count_line_completions(const LineAutomaton &automaton,
+                            const std::vector<std::uint8_t> &in_domains,
+                            std::vector<double> &out_filled,
+                            std::vector<double> &out_empty,
+                            LineScratch &scratch) {
+    const int N = static_cast<int>(in_domains.size());
+    out_filled.assign(N, 0.0);
+    out_empty.assign(N, 0.0);
+    if (!automaton.valid() || automaton.length() > N)
+        return false;
+
+    const int L = automaton.length();
+    const int slack = N - L;
+    const int W = static_cast<int>(state_window(automaton, N));
+    auto lo = [slack](int i) { return std::max(0, i - slack); };
+    auto hi = [L](int i) { return std::min(i, L); };
+    auto in_window = [&](int i, int k) { return k >= lo(i) && k <= hi(i); };
+
+    // Same sweeps as propagate_scalar with path counts instead of reachability bits
+    std::vector<double> &forward = scratch.forward_counts;
+    forward.assign(static_cast<size_t>(N + 1) * W, 0.0);
+    auto fwd = [&](int i, int k) -> double & { return forward[static_cast<size_t>(i) * W + (k - lo(i))]; };
+
+    fwd(0, 0) = 1.0;
+    for (int i = 0; i < N; ++i) {
+        for (int k = lo(i); k <= hi(i); ++k) {
+            const double paths = fwd(i, k);
+            if (paths == 0.0)
+                continue;
+            for (const std::uint8_t value : {D_EMPTY, D_FILLED}) {
+                if (!(in_domains[i] & value))
+                    continue;
+                const int nk = automaton.next(k, value);
+                if (nk >= 0 && in_window(i + 1, nk))
+                    fwd(i + 1, nk) += paths;
+            }
+        }
+    }
+    if (fwd(N, L) == 0.0)
+        return false;
+
+    std::vector<double> &backward_next = scratch.backward_next_counts;
+    std::vector<double> &backward_cur = scratch.backward_cur_counts;
+    backward_next.assign(W, 0.0);
+    backward_cur.assign(W, 0.0);
+    backward_next[L - lo(N)] = 1.0;
+
+    for (int i = N - 1; i >= 0; --i) {
+        std::fill(backward_cur.begin(), backward_cur.end(), 0.0);
+        for (int k = lo(i); k <= hi(i); ++k) {
+            for (const std::uint8_t value : {D_EMPTY, D_FILLED}) {
+                if (!(in_domains[i] & value))
+                    continue;
+                const int nk = automaton.next(k, value);
+                if (nk < 0 || !in_window(i + 1, nk))
+                    continue;
+                const double rest = backward_next[nk - lo(i + 1)];
+                backward_cur[k - lo(i)] += rest;
+                (value == D_FILLED ? out_filled : out_empty)[i] += fwd(i, k) * rest;
+            }
+        }
+        std::swap(backward_cur, backward_next);
+    }
+    return true;
+}
+
+size_t enumerate_line_completions(const LineAutomaton &automaton,
+                                  const std::vector<std::uint8_t> &in_domains,
+                                  std::vector<std::uint8_t> &out,
+                                  LineScratch &scratch) {
+    const int N = static_cast<int>(in_domains.size());
+    if (N == 0 || !automaton.valid() || automaton.length() > N)
+        return 0;
+
+    const int L = automaton.length();
+    const int slack = N - L;
+    const int W = static_cast<int>(state_window(automaton, N));
+    auto lo = [slack](int i) { return std::max(0, i - slack); };
+    auto hi = [L](int i) { return std::min(i, L); };
+    auto in_window = [&](int i, int k) { return k >= lo(i) && k <= hi(i); };
+
+    // Backward reachability over the whole line, the walk only takes edges that can still finish
+    std::vector<std::uint8_t> &finish = scratch.forward;
+    finish.assign(static_cast<size_t>(N + 1) * W, 0);
+    auto fin = [&](int i, int k) -> std::uint8_t & { return finish[static_cast<size_t>(i) * W + (k - lo(i))]; };
+
+    fin(N, L) = 1;
+    for (int i = N - 1; i >= 0; --i) {
+        for (int k = lo(i); k <= hi(i); ++k) {
+            for (const std::uint8_t value : {D_EMPTY, D_FILLED}) {
+                if (!(in_domains[i] & value))
+                    continue;
+                const int nk = automaton.next(k, value);
+                if (nk >= 0 && in_window(i + 1, nk) && fin(i + 1, nk))
+                    fin(i, k) = 1;
+            }
+        }
+    }
+    if (!fin(0, 0))
+        return 0;
+
+    CompletionWalk walk{automaton, in_domains, out, finish, N, slack, W};
+    out.resize(out.size() + N);
+    walk.walk(0, 0);
+    out.resize(out.size() - N); // drop the scratch block the walk was writing into
+    return walk.count;
+}
@@ -0,0 +1,151 @@
+#include "../../include/solvers/LineScheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Higher pops first
+std::int64_t static_score(LineSchedule policy, const LineAutomaton &automaton, int len) {
+    const std::int64_t slack = len - automaton.length();
+    switch (policy) {
+    case LineSchedule::LeastSlack:
+        return -slack;
+    case LineSchedule::CheapestFirst:
+        return -static_cast<std::int64_t>(len) * (std::min<std::int64_t>(slack, automaton.length()) + 1);
+    case LineSchedule::Fifo:
+    case LineSchedule::MostChanged:
+    default:
+        return 0;
+    }
+}
+
+} // namespace
+
+const char *line_schedule_name(LineSchedule schedule) {
+    switch (schedule) {
+    case LineSchedule::Fifo:
+        return "fifo";
+    case LineSchedule::MostChanged:
+        return "most-changed";
+    case LineSchedule::LeastSlack:
+        return "least-slack";
+    case LineSchedule::CheapestFirst:
+        return "cheapest-first";
+    default:
+        return "unknown";
+    }
+}
+
+void LineScheduler::reset(LineSchedule policy, const PuzzleAutomata &lines) {
+    policy_ = policy;
+    rows_ = static_cast<int>(lines.rows.size());
+    const int cols = static_cast<int>(lines.cols.size());
+    const size_t total = static_cast<size_t>(rows_ + cols);
+
+    size_ = 0;
+    pushes_ = 0;
+    head_ = 0;
+    ring_.assign(total, 0);
+    heap_.assign(total, 0);
+    heap_pos_.assign(total, -1);
+    score_.assign(total, 0);
+    static_score_.assign(total, 0);
+
+    for (int r = 0; r < rows_; ++r)
+        static_score_[r] = static_score(policy, lines.rows[r], cols);
+    for (int c = 0; c < cols; ++c)
+        static_score_[rows_ + c] = static_score(policy, lines.cols[c], rows_);
+}
+
+void LineScheduler::push(LineRef line) {
+    ++pushes_;
+    const int id = id_of(line);
+    const bool queued = heap_pos_[id] >= 0;
+
+    if (policy_ == LineSchedule::Fifo) {
+        if (queued)
+            return;
+        ring_[(head_ + size_) % ring_.size()] = id;
+        heap_pos_[id] = 0; // only used as the queued flag here
+        ++size_;
+        return;
+    }
+
+    if (queued) {
+        if (policy_ == LineSchedule::MostChanged) {
+            ++score_[id];
+            sift_up(static_cast<size_t>(heap_pos_[id]));
+        }
+        return;
+    }
+
+    score_[id] = static_score_[id] + 1;
+    heap_[size_] = id;
+    heap_pos_[id] = static_cast<int>(size_);
+    ++size_;
+    sift_up(size_ - 1);
+}
+
+LineRef LineScheduler::pop() {
+    int id;
+    if (policy_ == LineSchedule::Fifo) {
+        id = ring_[head_];
+        head_ = (head_ + 1) % ring_.size();
+        --size_;
+    } else {
+        id = heap_[0];
+        --size_;
+        if (size_ > 0) {
+            heap_[0] = heap_[size_];
+            heap_pos_[heap_[0]] = 0;
+            sift_down(0);
+        }
+    }
+    heap_pos_[id] = -1;
+    return ref_of(id);
+}
+
+void LineScheduler::clear() {
+    while (!empty())
+        pop();
+}
+
+// Ties go to the lower id so rows come before columns, like the Fifo seed order
+bool LineScheduler::before(int a, int b) const {
+    if (score_[a] != score_[b])
+        return score_[a] > score_[b];
+    return a < b;
+}
+
+void LineScheduler::sift_up(size_t pos) {
+    while (pos > 0) {
+        const size_t parent = (pos - 1) / 2;
+        if (!before(heap_[pos], heap_[parent]))
+            break;
+        std::swap(heap_[pos], heap_[parent]);
+        heap_pos_[heap_[pos]] = static_cast<int>(pos);
+        heap_pos_[heap_[parent]] = static_cast<int>(parent);
+        pos = parent;
+    }
+}
+
+void LineScheduler::sift_down(size_t pos) {
+    for (;;) {
+        const size_t left = pos * 2 + 1;
+        const size_t right = left + 1;
+        size_t best = pos;
+        if (left < size_ && before(heap_[left], heap_[best]))
+            best = left;
+        if (right < size_ && before(heap_[right], heap_[best]))
+            best = right;
+        if (best == pos)
+            return;
+        std::swap(heap_[pos], heap_[best]);
+        heap_pos_[heap_[pos]] = static_cast<int>(pos);
+        heap_pos_[heap_[best]] = static_cast<int>(best);
+        pos = best;
+    }
+}
@@ -1,22 +1,223 @@
-
 #include "../../include/solvers/NonogramSolver.h"
 
-NonogramSolver::NonogramSolver() = default;
+#include "../../include/NonogramVerifier.h"
+#include "../../include/SolutionCache.h"
+#include "../../include/solvers/DomainGrid.h"
+
+#include <chrono>
+#include <iterator>
+#include <utility>
+
+NonogramSolver::NonogramSolver() {
+    strategies_.push_back(std::make_unique<TrivialConstraintsSolver>());
+    strategies_.push_back(std::make_unique<OverlapLineSolver>());
+    auto dp = std::make_unique<DPSolver>();
+    dp_ = dp.get();
+    strategies_.push_back(std::move(dp));
+}
+
+void NonogramSolver::addStrategy(std::unique_ptr<ISolverStrategy> strategy) {
+    strategies_.insert(std::prev(strategies_.end()), std::move(strategy));
+}
 
 bool NonogramSolver::solve(Nonogram &puzzle, std::string &out_error) {
+    if (cache_ && cache_->lookup(puzzle)) {
+        out_error.clear();
+        stats_ = SolverStats{};
+        stats_.cache_hits = 1;
+        strategy_stats_.clear();
+        search_allocations_ = 0;
+        status_ = SolveStatus::Solved;
+        return true;
+    }
+
+    SolveBudget budget(limits_);
+    DomainGrid g;
+    bool at_fixpoint = false;
+    if (!start(puzzle, g, budget, at_fixpoint, out_error))
+        return false;
+
+    const bool is_solved = dp_->solve(puzzle, g, out_error, at_fixpoint);
+    stats_.add(dp_->stats());
+    search_allocations_ = dp_->searchAllocations();
+    status_ = dp_->status();
+    if (status_ == SolveStatus::Solved || status_ == SolveStatus::TimedOut)
+        write_cells(g, puzzle);
+    // the solve succeeded whether or not the cache could keep it
+    std::string cache_error;
+    if (cache_ && status_ == SolveStatus::Solved)
+        cache_->store(puzzle, cache_error);
+    return is_solved;
+}
+
+bool NonogramSolver::countSolutions(Nonogram &puzzle, int limit, SolutionCount &out, std::string &out_error) {
+    out = SolutionCount{};
+    out.limit = limit;
+    SolveBudget budget(limits_);
+    DomainGrid g;
+    bool at_fixpoint = false;
+    if (!start(puzzle, g, budget, at_fixpoint, out_error)) {
+        // a contradiction in the pipeline is a count of 0, not an error
+        out.exhausted = status_ == SolveStatus::NoSolution;
+        if (out.exhausted)
+            out_error.clear();
+        return out.exhausted;
+    }
+
+    const bool ok = dp_->countSolutions(puzzle, g, limit, out, out_error, at_fixpoint);
+    stats_.add(dp_->stats());
+    search_allocations_ = dp_->searchAllocations();
+    status_ = dp_->status();
+    if (out.solutions > 0 || status_ == SolveStatus::TimedOut)
+        write_cells(g, puzzle);
+    return ok;
+}
+
+bool NonogramSolver::start(Nonogram &puzzle, DomainGrid &g, SolveBudget &budget, bool &out_at_fixpoint,
+                           std::string &out_error) {
     out_error.clear();
+    out_at_fixpoint = false;
+    stats_ = SolverStats{};
+    strategy_stats_.clear();
+    search_allocations_ = 0;
+    status_ = SolveStatus::Failed;
+
+    if (puzzle.rows() == 0 || puzzle.cols() == 0) {
+        out_error = "NonogramSolver: puzzle has zero size";
+        return false;
+    }
+    if (puzzle.cells.rows() != puzzle.rows() || puzzle.cells.cols() != puzzle.cols()) {
+        puzzle.resize_from_clues();
+    }
 
-    bool is_solved;
+    // The only conversion of the solve, every strategy and the search work on g
+    g = domains_from_cells(puzzle);
+    configure(*dp_, limits_.limited() ? &budget : nullptr);
+    if (run_pipeline(puzzle, g, budget, out_at_fixpoint, out_error) == LineResult::Contradiction) {
+        status_ = SolveStatus::NoSolution;
+        return false;
+    }
+    if (budget.stopped()) {
+        status_ = SolveStatus::TimedOut;
+        write_cells(g, puzzle);
+        out_error = "NonogramSolver: stopped early (" + std::string(solve_cutoff_name(budget.cutoff())) + ")";
+        return false;
+    }
+    return true;
+}
 
-    {
-        TrivialConstraintsSolver strategy;
-        strategy.solve(puzzle, out_error);
+LineResult NonogramSolver::run_pipeline(const Nonogram &puzzle, DomainGrid &g, const SolveBudget &budget,
+                                        bool &out_at_fixpoint, std::string &out_error) {
+    for (const auto &strategy : strategies_) {
+        StrategyStats entry;
+        entry.name = strategy->name();
+        strategy_stats_.push_back(entry);
     }
 
-    {
-        DPSolver strategy;
-        is_solved = strategy.solve(puzzle, out_error);
+    bool changed = false;
+    size_t unknown = unknown_cells(g);
+    size_t i = 0;
+    size_t last_change = strategies_.size();
+    out_at_fixpoint = false;
+    while (i < strategies_.size() && unknown > 0 && !budget.stopped()) {
+        // Every strategy since this one's last change ran without finding anything, and it left its own fixpoint,
+        // so it has nothing to add. The ones after it haven't seen its change yet.
+        if (i == last_change) {
+            ++i;
+            continue;
+        }
+        ISolverStrategy &strategy = *strategies_[i];
+        const auto t0 = std::chrono::steady_clock::now();
+        const LineResult result = strategy.propagate(puzzle, g, out_error);
+        const size_t unknown_after = unknown_cells(g);
+
+        StrategyStats &entry = strategy_stats_[i];
+        ++entry.runs;
+        entry.fixed_cells += unknown - unknown_after;
+        entry.ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        stats_.add(strategy.stats());
+        unknown = unknown_after;
+
+        if (result == LineResult::Contradiction)
+            return result;
+        // g stays at the DP fixpoint until another strategy changes it
+        if (&strategy == dp_)
+            out_at_fixpoint = true;
+        else if (result == LineResult::Changed)
+            out_at_fixpoint = false;
+        // Domains only shrink, so every Changed brings the loop closer to its end
+        if (result == LineResult::Changed) {
+            changed = true;
+            last_change = i;
+        }
+        i = result == LineResult::Changed && i > 0 ? 0 : i + 1;
     }
 
-    return is_solved;
+    // Decided to the last cell before dp-lines had a turn. Not every strategy checks every line it didn't
+    // change, so the grid is checked on packed words, which costs far less than the search repeating the
+    // root propagation. A grid that fits every clue is the fixpoint.
+    if (unknown == 0 && !out_at_fixpoint) {
+        std::string grid_error;
+        if (!verify_grid(puzzle, g.cells, grid_error)) {
+            out_error = "NonogramSolver: contradiction in the decided grid (" + grid_error + ")";
+            return LineResult::Contradiction;
+        }
+        out_at_fixpoint = true;
+    }
+    return changed ? LineResult::Changed : LineResult::NoChange;
+}
+
+void NonogramSolver::configure(DPSolver &strategy, SolveBudget *budget) {
+    strategy.setLineSchedule(schedule_);
+    strategy.setThreadCount(threads_);
+    strategy.setProbeMode(probe_mode_);
+    strategy.setBranchRule(branch_rule_);
+    strategy.setValueOrder(value_order_);
+    strategy.setBranchMode(branch_mode_);
+    strategy.setLimits(limits_);
+    strategy.setSharedBudget(budget);
+}
+
+void NonogramSolver::setLimits(const SolveLimits &limits) {
+    limits_ = limits;
+}
+
+void NonogramSolver::setCache(SolutionCache *cache) {
+    cache_ = cache;
+}
+
+void NonogramSolver::setLineSchedule(LineSchedule schedule) {
+    schedule_ = schedule;
+}
+
+void NonogramSolver::setThreadCount(int threads) {
+    threads_ = threads;
+}
+
+void NonogramSolver::setProbeMode(ProbeMode mode) {
+    probe_mode_ = mode;
+}
+
+void NonogramSolver::setBranchRule(BranchRule rule) {
+    branch_rule_ = rule;
+}
+
+void NonogramSolver::setValueOrder(ValueOrder order) {
+    value_order_ = order;
+}
+
+void NonogramSolver::setBranchMode(BranchMode mode) {
+    branch_mode_ = mode;
+}
+
+std::size_t NonogramSolver::linePropagations() const {
+    return stats_.line_propagations();
+}
+
+std::size_t NonogramSolver::searchNodes() const {
+    return stats_.nodes;
+}
+
+std::size_t NonogramSolver::searchAllocations() const {
+    return search_allocations_;
 }
@@ -0,0 +1,189 @@
+#include "../../include/solvers/OverlapLineSolver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+// Leftmost start of every block such that no block covers an Empty cell, blocks are separated by a gap
+// and every Filled cell is covered. False if there's no such placement.
+// Blocks only ever move right, a block is pushed back only to cover a Filled cell it left behind.
+bool leftmost_starts(const std::vector<int> &clues, const std::vector<std::uint8_t> &line,
+                     std::vector<int> &next_filled, std::vector<int> &next_empty, std::vector<int> &out_starts) {
+    const int n = static_cast<int>(line.size());
+    const int k = static_cast<int>(clues.size());
+
+    // next_*[i]: first index >= i holding a decided Filled / Empty cell, n if none
+    next_filled.assign(n + 1, n);
+    next_empty.assign(n + 1, n);
+    for (int i = n - 1; i >= 0; --i) {
+        next_filled[i] = line[i] == D_FILLED ? i : next_filled[i + 1];
+        next_empty[i] = line[i] == D_EMPTY ? i : next_empty[i + 1];
+    }
+
+    out_starts.assign(k, 0);
+    int j = 0;
+    int p = 0;
+    for (;;) {
+        if (j == k) {
+            // a Filled cell after the last block has to be covered by it
+            const int tail = k > 0 ? out_starts[k - 1] + clues[k - 1] : 0;
+            const int f = next_filled[tail];
+            if (f == n)
+                return true;
+            if (k == 0)
+                return false;
+            j = k - 1;
+            p = f - clues[j] + 1;
+            continue;
+        }
+
+        const int len = clues[j];
+        const int gap_start = j > 0 ? out_starts[j - 1] + clues[j - 1] : 0;
+        p = std::max(p, j > 0 ? gap_start + 1 : 0);
+
+        bool placed = false;
+        bool backtrack = false;
+        while (!placed && !backtrack) {
+            if (p + len > n)
+                return false;
+            const int f = next_filled[gap_start];
+            if (f < p) {
+                // the gap before this block has a Filled cell, the previous block has to take it
+                if (j == 0)
+                    return false;
+                backtrack = true;
+                --j;
+                p = f - clues[j] + 1;
+                break;
+            }
+            const int e = next_empty[p];
+            if (e < p + len) {
+                p = e + 1;
+            } else if (p + len < n && line[p + len] == D_FILLED) {
+                ++p;
+            } else {
+                placed = true;
+            }
+        }
+        if (placed) {
+            out_starts[j] = p;
+            ++j;
+            p = 0;
+        }
+    }
+}
+
+} // namespace
+
+LineResult OverlapLineSolver::solve_line(const std::vector<int> &clues, std::vector<std::uint8_t> &line) {
+    const int n = static_cast<int>(line.size());
+    const int k = static_cast<int>(clues.size());
+
+    if (!leftmost_starts(clues, line, next_filled_, next_empty_, left_))
+        return LineResult::Contradiction;
+
+    // rightmost placement is the leftmost one of the mirrored line
+    reversed_clues_.assign(clues.rbegin(), clues.rend());
+    reversed_line_.assign(line.rbegin(), line.rend());
+    if (!leftmost_starts(reversed_clues_, reversed_line_, next_filled_, next_empty_, right_))
+        return LineResult::Contradiction;
+    std::reverse(right_.begin(), right_.end());
+    for (int j = 0; j < k; ++j)
+        right_[j] = n - right_[j] - clues[j];
+
+    bool changed = false;
+    auto set = [&](int i, std::uint8_t value) {
+        if (line[i] != value) {
+            line[i] = value;
+            changed = true;
+        }
+    };
+
+    // Block j lies within [left_[j], right_[j] + len) in every solution, the cells outside all of those
+    // ranges are Empty and the cells every position of block j covers are Filled
+    int reach = 0; // first cell not yet known to be inside a block range
+    for (int j = 0; j < k; ++j) {
+        for (int i = reach; i < left_[j]; ++i)
+            set(i, D_EMPTY);
+        for (int i = right_[j]; i < left_[j] + clues[j]; ++i)
+            set(i, D_FILLED);
+        reach = std::max(reach, right_[j] + clues[j]);
+    }
+    for (int i = reach; i < n; ++i)
+        set(i, D_EMPTY);
+
+    return changed ? LineResult::Changed : LineResult::NoChange;
+}
+
+bool OverlapLineSolver::solve(Nonogram &puzzle, std::string &error) {
+    DomainGrid g = domains_from_cells(puzzle);
+    const auto res = propagate(puzzle, g, error);
+    if (res == LineResult::Contradiction)
+        return false;
+    write_cells(g, puzzle);
+    return res == LineResult::Changed;
+}
+
+LineResult OverlapLineSolver::propagate(const Nonogram &puzzle, DomainGrid &g, std::string &error) {
+    error.clear();
+    stats_ = SolverStats{};
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::size_t unknown_before = unknown_cells(g);
+    const auto res = sweep(puzzle, g, error);
+    stats_.overlap_fixed_cells = unknown_before - unknown_cells(g);
+    stats_.overlap_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    return res;
+}
+
+LineResult OverlapLineSolver::sweep(const Nonogram &puzzle, DomainGrid &g, std::string &error) {
+    // a row is rechecked when a column changed one of its cells and the other way round
+    std::vector<char> row_dirty(g.R, 1);
+    std::vector<char> col_dirty(g.C, 1);
+    bool any_dirty = true;
+    bool changed = false;
+
+    while (any_dirty) {
+        any_dirty = false;
+        for (const bool is_row : {true, false}) {
+            const int lines = is_row ? g.R : g.C;
+            const int len = is_row ? g.C : g.R;
+            std::vector<char> &dirty = is_row ? row_dirty : col_dirty;
+            std::vector<char> &crossing = is_row ? col_dirty : row_dirty;
+
+            for (int idx = 0; idx < lines; ++idx) {
+                if (!dirty[idx])
+                    continue;
+                dirty[idx] = 0;
+
+                line_.resize(len);
+                g.read_line(is_row, idx, line_.data());
+
+                const auto &clues = is_row ? puzzle.row_clues[idx] : puzzle.col_clues[idx];
+                const LineResult res = solve_line(clues, line_);
+                if (res == LineResult::Contradiction) {
+                    error = std::string("OverlapLineSolver: no placement fits ") + (is_row ? "row " : "column ") +
+                            std::to_string(idx);
+                    return res;
+                }
+                if (res == LineResult::NoChange)
+                    continue;
+
+                for (int i = 0; i < len; ++i) {
+                    const int r = is_row ? idx : i;
+                    const int c = is_row ? i : idx;
+                    if (g.at(r, c) != line_[i]) {
+                        g.set(r, c, line_[i]);
+                        crossing[i] = 1;
+                        any_dirty = true;
+                    }
+                }
+                changed = true;
+            }
+        }
+    }
+    return changed ? LineResult::Changed : LineResult::NoChange;
+}
@@ -0,0 +1,58 @@
+#include "../../include/solvers/SolveBudget.h"
+
+const char *solve_status_name(SolveStatus status) {
+    switch (status) {
+    case SolveStatus::Solved:
+        return "solved";
+    case SolveStatus::NoSolution:
+        return "unsolved";
+    case SolveStatus::TimedOut:
+        return "timed_out";
+    case SolveStatus::Failed:
+        return "failed";
+    default:
+        return "unknown";
+    }
+}
+
+const char *solve_cutoff_name(SolveCutoff cutoff) {
+    switch (cutoff) {
+    case SolveCutoff::None:
+        return "none";
+    case SolveCutoff::Deadline:
+        return "deadline";
+    case SolveCutoff::NodeBudget:
+        return "node budget";
+    case SolveCutoff::Cancelled:
+        return "cancelled";
+    default:
+        return "unknown";
+    }
+}
+
+SolveBudget::SolveBudget(const SolveLimits &limits) : limits_(limits) {
+    const auto timeout = std::chrono::duration<double, std::milli>(limits_.timeout_ms);
+    deadline_ = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+}
+
+bool SolveBudget::poll() {
+    if (stopped())
+        return true;
+    if (limits_.cancel && limits_.cancel->cancelled())
+        stop(SolveCutoff::Cancelled);
+    else if (limits_.timeout_ms > 0.0 && std::chrono::steady_clock::now() >= deadline_)
+        stop(SolveCutoff::Deadline);
+    return stopped();
+}
+
+bool SolveBudget::add_nodes(std::size_t nodes) {
+    if (limits_.node_budget > 0 && nodes_.fetch_add(nodes, std::memory_order_relaxed) + nodes > limits_.node_budget)
+        stop(SolveCutoff::NodeBudget);
+    return stopped();
+}
+
+void SolveBudget::stop(SolveCutoff cutoff) {
+    // the first limit hit is the one reported
+    int none = static_cast<int>(SolveCutoff::None);
+    cutoff_.compare_exchange_strong(none, static_cast<int>(cutoff), std::memory_order_relaxed);
+}
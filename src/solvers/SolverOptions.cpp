@@ -0,0 +1,80 @@
+#include "../../include/solvers/SolverOptions.h"
+
+#include "../../include/solvers/NonogramSolver.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+// value is the setting's full name (name_of) or its short form
+template <typename T, size_t N>
+bool parse_value(const std::string &value, const T (&values)[N], const char *const (&short_names)[N],
+                 const char *(*name_of)(T), T &out) {
+    for (size_t i = 0; i < N; ++i) {
+        if (value == name_of(values[i]) || value == short_names[i]) {
+            out = values[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+constexpr LineSchedule kSchedules[] = {LineSchedule::Fifo, LineSchedule::MostChanged, LineSchedule::LeastSlack,
+                                       LineSchedule::CheapestFirst};
+constexpr const char *kScheduleShort[] = {"fifo", "most-changed", "least-slack", "cheapest"};
+constexpr ProbeMode kProbeModes[] = {ProbeMode::Off, ProbeMode::Root, ProbeMode::EveryNode};
+constexpr const char *kProbeShort[] = {"off", "root", "every"};
+constexpr BranchRule kBranchRules[] = {BranchRule::FirstUnknown, BranchRule::MostConstrainedLine,
+                                       BranchRule::ProbeImpact};
+constexpr const char *kBranchShort[] = {"first", "constrained", "probe"};
+constexpr ValueOrder kValueOrders[] = {ValueOrder::FilledFirst, ValueOrder::EmptyFirst, ValueOrder::Feasibility};
+constexpr const char *kValueShort[] = {"filled", "empty", "feasibility"};
+constexpr BranchMode kBranchModes[] = {BranchMode::Cells, BranchMode::Lines};
+constexpr const char *kBranchModeShort[] = {"cells", "lines"};
+
+} // namespace
+
+void apply_solver_options(NonogramSolver &solver, const SolverOptions &options) {
+    solver.setLineSchedule(options.schedule);
+    solver.setThreadCount(options.threads);
+    solver.setProbeMode(options.probe_mode);
+    solver.setBranchRule(options.branch_rule);
+    solver.setValueOrder(options.value_order);
+    solver.setBranchMode(options.branch_mode);
+}
+
+bool is_solver_option(const std::string &arg) {
+    return arg == "--schedule" || arg == "--search-threads" || arg == "--probe" || arg == "--branch" ||
+           arg == "--value" || arg == "--branch-mode";
+}
+
+bool parse_solver_option(const std::string &arg, const std::string &value, SolverOptions &options,
+                         std::string &out_error) {
+    out_error.clear();
+    bool ok = false;
+    if (arg == "--schedule") {
+        ok = parse_value(value, kSchedules, kScheduleShort, line_schedule_name, options.schedule);
+    } else if (arg == "--search-threads") {
+        options.threads = std::max(1, std::atoi(value.c_str()));
+        ok = true;
+    } else if (arg == "--probe") {
+        ok = parse_value(value, kProbeModes, kProbeShort, probe_mode_name, options.probe_mode);
+    } else if (arg == "--branch") {
+        ok = parse_value(value, kBranchRules, kBranchShort, branch_rule_name, options.branch_rule);
+    } else if (arg == "--value") {
+        ok = parse_value(value, kValueOrders, kValueShort, value_order_name, options.value_order);
+    } else if (arg == "--branch-mode") {
+        ok = parse_value(value, kBranchModes, kBranchModeShort, branch_mode_name, options.branch_mode);
+    }
+    if (!ok)
+        out_error = "Unknown value for " + arg + ": " + value;
+    return ok;
+}
+
+std::string describe_solver_options(const SolverOptions &options) {
+    return std::string("schedule ") + line_schedule_name(options.schedule) + ", search threads " +
+           std::to_string(options.threads) + ", probe " + probe_mode_name(options.probe_mode) +
+           ", branch " + branch_rule_name(options.branch_rule) + "/" + value_order_name(options.value_order) +
+           " on " + branch_mode_name(options.branch_mode);
+}
@@ -1,20 +1,25 @@
 #include "../../include/solvers/TrivialConstraintsSolver.h"
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
 namespace {
-bool setCell(Cell &cell, Cell target, bool &madeProgress) {
-    if ((target == Cell::Filled && cell == Cell::Empty) ||
-        (target == Cell::Empty && cell == Cell::Filled))
+// target is a domain with a single value
+bool setCell(DomainGrid &g, int row, int col, std::uint8_t target, bool &madeProgress) {
+    const std::uint8_t cell = g.at(row, col);
+    if ((cell & target) == 0)
         return false;
 
     if (cell != target) {
-        cell = target;
+        g.set(row, col, target);
         madeProgress = true;
     }
     return true;
 }
 
-template <typename CellAccessor>
-LineResult solveExactFitLine(const std::vector<int> &clues, size_t line_length, bool &madeProgress, CellAccessor cellAt) {
+template <typename CellSetter>
+LineResult solveExactFitLine(const std::vector<int> &clues, size_t line_length, bool &madeProgress, CellSetter setAt) {
     int sum = 0;
     for (int run_length : clues)
         sum += run_length;
@@ -31,12 +36,12 @@ LineResult solveExactFitLine(const std::vector<int> &clues, size_t line_length,
         int run_length = clues[run_index];
 
         for (int run_cell = 0; run_cell < run_length; run_cell++, cell_index++) {
-            if (!setCell(cellAt(cell_index), Cell::Filled, madeProgress))
+            if (!setAt(cell_index, D_FILLED, madeProgress))
                 return LineResult::Contradiction;
         }
 
         if (run_index + 1 < clues.size()) {
-            if (!setCell(cellAt(cell_index), Cell::Empty, madeProgress))
+            if (!setAt(cell_index, D_EMPTY, madeProgress))
                 return LineResult::Contradiction;
 
             cell_index++;
@@ -46,38 +51,42 @@ LineResult solveExactFitLine(const std::vector<int> &clues, size_t line_length,
     return madeProgress ? LineResult::Changed : LineResult::NoChange;
 }
 
-template <typename CellAccessor>
-LineResult forceWholeLine(size_t line_length, Cell required, bool &madeProgress, CellAccessor cellAt) {
+template <typename CellSetter>
+LineResult forceWholeLine(size_t line_length, std::uint8_t required, bool &madeProgress, CellSetter setAt) {
     for (size_t cell_index = 0; cell_index < line_length; cell_index++) {
-        if (!setCell(cellAt(cell_index), required, madeProgress))
+        if (!setAt(cell_index, required, madeProgress))
             return LineResult::Contradiction;
     }
 
     return madeProgress ? LineResult::Changed : LineResult::NoChange;
 }
 
-template <typename CellAccessor>
-LineResult startLine(const std::vector<int> &clues, size_t line_length, bool &madeProgress, CellAccessor cellAt) {
+template <typename CellSetter>
+LineResult startLine(const std::vector<int> &clues, size_t line_length, bool &madeProgress, CellSetter setAt) {
     if (clues.empty())
-        return forceWholeLine(line_length, Cell::Empty, madeProgress, cellAt);
+        return forceWholeLine(line_length, D_EMPTY, madeProgress, setAt);
 
-    return solveExactFitLine(clues, line_length, madeProgress, cellAt);
+    return solveExactFitLine(clues, line_length, madeProgress, setAt);
 }
 
-LineResult applyLine(Nonogram &puzzle, int index, bool isRow) {
+LineResult applyLine(const Nonogram &puzzle, DomainGrid &g, int index, bool isRow) {
     bool madeProgress = false;
     if (isRow) {
-        auto cellAt = [&puzzle, index](size_t cell_index) -> Cell & { return puzzle.cells[index][cell_index]; };
-        return startLine(puzzle.row_clues.at(index), puzzle.cells[index].size(), madeProgress, cellAt);
+        auto setAt = [&g, index](size_t cell_index, std::uint8_t target, bool &progress) {
+            return setCell(g, index, static_cast<int>(cell_index), target, progress);
+        };
+        return startLine(puzzle.row_clues.at(index), static_cast<size_t>(g.C), madeProgress, setAt);
     }
-    auto cellAt = [&puzzle, index](size_t row_index) -> Cell & { return puzzle.cells[row_index][index]; };
-    return startLine(puzzle.col_clues.at(index), puzzle.rows(), madeProgress, cellAt);
+    auto setAt = [&g, index](size_t row_index, std::uint8_t target, bool &progress) {
+        return setCell(g, static_cast<int>(row_index), index, target, progress);
+    };
+    return startLine(puzzle.col_clues.at(index), static_cast<size_t>(g.R), madeProgress, setAt);
 }
 
-LineResult applyAllLines(Nonogram &puzzle, int count, bool isRow) {
+LineResult applyAllLines(const Nonogram &puzzle, DomainGrid &g, int count, bool isRow) {
     LineResult result = LineResult::NoChange;
     for (int i = 0; i < count; i++) {
-        LineResult temp = applyLine(puzzle, i, isRow);
+        LineResult temp = applyLine(puzzle, g, i, isRow);
         if (temp == LineResult::Contradiction)
             return LineResult::Contradiction;
         if (temp == LineResult::Changed)
@@ -87,9 +96,9 @@ LineResult applyAllLines(Nonogram &puzzle, int count, bool isRow) {
     return result;
 }
 
-LineResult applyPass(Nonogram &puzzle) {
-    LineResult rows = applyAllLines(puzzle, puzzle.rows(), true);
-    LineResult cols = applyAllLines(puzzle, puzzle.cols(), false);
+LineResult applyPass(const Nonogram &puzzle, DomainGrid &g) {
+    LineResult rows = applyAllLines(puzzle, g, g.R, true);
+    LineResult cols = applyAllLines(puzzle, g, g.C, false);
     if (rows == LineResult::Contradiction || cols == LineResult::Contradiction)
         return LineResult::Contradiction;
 
@@ -98,15 +107,27 @@ LineResult applyPass(Nonogram &puzzle) {
 } // namespace
 
 bool TrivialConstraintsSolver::solve(Nonogram &puzzle, std::string &error) {
-    error.clear();
-
-    const auto res = applyPass(puzzle);
-    if (res == LineResult::Contradiction) {
-        error = "TrivialConstraintsSolver: contradiction detected";
+    DomainGrid g = domains_from_cells(puzzle);
+    const auto res = propagate(puzzle, g, error);
+    if (res == LineResult::Contradiction)
         return false;
-    }
+    write_cells(g, puzzle);
     return res == LineResult::Changed;
 }
 
+LineResult TrivialConstraintsSolver::propagate(const Nonogram &puzzle, DomainGrid &g, std::string &error) {
+    error.clear();
+    stats_ = SolverStats{};
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::size_t unknown_before = unknown_cells(g);
+    const auto res = applyPass(puzzle, g);
+    stats_.trivial_fixed_cells = unknown_before - unknown_cells(g);
+    stats_.trivial_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    if (res == LineResult::Contradiction)
+        error = "TrivialConstraintsSolver: contradiction detected";
+    return res;
+}
+
 
 
@@ -0,0 +1,190 @@
+#include "../../include/solvers/WorkStealingSearch.h"
+#include "../../include/solvers/DPSearch.h"
+
+#include <thread>
+#include <utility>
+
+namespace {
+
+// longest an idle worker sleeps before it looks at the budget again
+constexpr std::chrono::milliseconds kIdleWait{1};
+
+} // namespace
+
+bool SearchWorker::should_stop() const {
+    return pool_.stopped();
+}
+
+bool SearchWorker::wants_work() const {
+    return pool_.has_idle() && pool_.queued(id_) == 0;
+}
+
+void SearchWorker::donate(const DomainGrid &g, int cell, std::uint8_t value) {
+    pool_.push(id_, SearchTask{g, cell, value});
+}
+
+void SearchWorker::donate_line(const DomainGrid &g, LineRef line, const std::uint8_t *values) {
+    SearchTask task{g, -1, 0};
+    const int len = line.is_row ? g.C : g.R;
+    for (int i = 0; i < len; ++i)
+        task.grid.set(line.is_row ? line.idx : i, line.is_row ? i : line.idx, values[i]);
+    pool_.push(id_, std::move(task));
+}
+
+WorkStealingPool::WorkStealingPool(int threads) {
+    for (int i = 0; i < threads; ++i)
+        queues_.push_back(std::make_unique<WorkerQueue>());
+}
+
+void WorkStealingPool::push(int worker, SearchTask task) {
+    pending_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues_[worker]->m);
+        queues_[worker]->tasks.push_back(std::move(task));
+    }
+    // A worker going idle counts itself before it looks at the queues, so either it sees this task
+    // or this sees it idle. Taking wait_mutex_ keeps the notify from landing between its look and its wait.
+    if (has_idle()) {
+        { std::lock_guard<std::mutex> lock(wait_mutex_); }
+        work_ready_.notify_one();
+    }
+}
+
+void WorkStealingPool::finish_task() {
+    if (pending_.fetch_sub(1) == 1)
+        wake_all();
+}
+
+void WorkStealingPool::wait_for_work(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    work_ready_.wait_for(lock, timeout, [&] { return stopped() || exhausted() || has_queued(); });
+}
+
+bool WorkStealingPool::has_queued() const {
+    for (const auto &queue : queues_) {
+        std::lock_guard<std::mutex> lock(queue->m);
+        if (!queue->tasks.empty())
+            return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::wake_all() {
+    { std::lock_guard<std::mutex> lock(wait_mutex_); }
+    work_ready_.notify_all();
+}
+
+bool WorkStealingPool::take(int worker, SearchTask &out_task) {
+    {
+        // own work, newest first, keeps the subtree hot in this thread's cache
+        WorkerQueue &own = *queues_[worker];
+        std::lock_guard<std::mutex> lock(own.m);
+        if (!own.tasks.empty()) {
+            out_task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // steal the oldest task of someone else, it sits closest to the root so it's the biggest
+    const int n = static_cast<int>(queues_.size());
+    for (int k = 1; k < n; ++k) {
+        WorkerQueue &victim = *queues_[(worker + k) % n];
+        std::lock_guard<std::mutex> lock(victim.m);
+        if (!victim.tasks.empty()) {
+            out_task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t WorkStealingPool::queued(int worker) const {
+    std::lock_guard<std::mutex> lock(queues_[worker]->m);
+    return queues_[worker]->tasks.size();
+}
+
+bool WorkStealingPool::publish(const DomainGrid &g) {
+    std::lock_guard<std::mutex> lock(solution_mutex_);
+    if (found_)
+        return false;
+    found_ = true;
+    solution_ = g;
+    stop_.store(true);
+    wake_all();
+    return true;
+}
+
+namespace {
+
+void run_worker(WorkStealingPool &pool, int id, const PuzzleAutomata &lines, LineKernel kernel,
+                LineSchedule schedule, BranchRule rule, ValueOrder order, BranchMode mode, int R, int C,
+                SolveBudget *budget, SolverStats &totals, std::mutex &totals_mutex) {
+    SolveContext ctx(lines, kernel, schedule, R, C);
+    ctx.budget = budget;
+    SearchWorker worker(pool, id);
+    const auto brancher = make_branch_heuristic(rule, order, R, C);
+    SearchHooks hooks;
+    hooks.worker = &worker;
+    hooks.brancher = brancher.get();
+    hooks.mode = mode;
+    DomainGrid g;
+
+    bool idle = false;
+    SearchTask task;
+    while (!pool.stopped() && !(budget && budget->stopped())) {
+        if (!pool.take(id, task)) {
+            if (pool.exhausted())
+                break;
+            if (!idle) {
+                pool.set_idle(true);
+                idle = true;
+            }
+            pool.wait_for_work(kIdleWait);
+            continue;
+        }
+        if (idle) {
+            pool.set_idle(false);
+            idle = false;
+        }
+
+        g.swap(task.grid);
+        ctx.trail.clear();
+        const bool consistent = task.at_fixpoint  ? true
+                                : task.cell < 0 ? enforce_arc_consistency(ctx, g)
+                                                : assign_and_propagate(ctx, g, task.cell, task.value);
+        if (consistent && search_subtree(ctx, g, hooks))
+            pool.publish(g);
+        pool.finish_task();
+    }
+
+    if (idle)
+        pool.set_idle(false);
+    std::lock_guard<std::mutex> lock(totals_mutex);
+    totals.add(ctx.totals());
+}
+
+} // namespace
+
+bool work_stealing_search(const PuzzleAutomata &lines, LineKernel kernel, LineSchedule schedule,
+                          BranchRule rule, ValueOrder order, BranchMode mode, DomainGrid &g, int threads,
+                          SolveBudget *budget, SolverStats &out_stats) {
+    WorkStealingPool pool(threads);
+    pool.push(0, SearchTask{g, -1, 0, true});
+
+    SolverStats totals;
+    std::mutex totals_mutex;
+    std::vector<std::thread> workers;
+    for (int id = 0; id < threads; ++id)
+        workers.emplace_back(run_worker, std::ref(pool), id, std::cref(lines), kernel, schedule, rule, order, mode,
+                             g.R, g.C, budget, std::ref(totals), std::ref(totals_mutex));
+    for (auto &t : workers)
+        t.join();
+
+    out_stats.add(totals);
+    if (!pool.found())
+        return false;
+    g = pool.solution();
+    return true;
+}
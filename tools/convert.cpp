@@ -0,0 +1,137 @@
+// Converts puzzles between the puzzles/ text format and the binary .ngb format (NonogramBinaryFormat.h).
+//
+// convert [--to binary|text] IN OUT
+//
+// IN is a puzzle file or a directory. A file is converted to OUT, without --to binary input becomes text
+// and anything else binary. For a directory every .txt file (to binary) and .ngb file (to text) in it is
+// converted into the directory OUT under the same name with the other extension.
+// Text written from a binary file has no grid, only the clues.
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "../include/Nonogram.h"
+#include "../include/NonogramBinaryFormat.h"
+#include "../include/NonogramBinarySource.h"
+#include "../include/NonogramSource.h"
+#include "../include/NonogramTextFormat.h"
+#include "../include/core/MappedFile.h"
+
+namespace {
+
+enum class Target { Auto,
+                    Binary,
+                    Text
+};
+
+struct Options {
+    Target to = Target::Auto;
+    std::string in;
+    std::string out;
+};
+
+bool parse_args(int argc, char **argv, Options &options) {
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--to" && i + 1 < argc) {
+            const std::string to = argv[++i];
+            if (to == "binary") {
+                options.to = Target::Binary;
+            } else if (to == "text") {
+                options.to = Target::Text;
+            } else {
+                std::cerr << "Unknown target: " << to << " (binary or text)\n";
+                return false;
+            }
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Unknown or incomplete option: " << arg << "\n";
+            return false;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if (paths.size() != 2) {
+        std::cerr << "Expected an input and an output path\n";
+        return false;
+    }
+    options.in = paths[0];
+    options.out = paths[1];
+    return true;
+}
+
+bool is_binary_file(const std::string &path) {
+    nonogram::core::MappedFile file;
+    return file.open(path) && BinaryFormat::is_binary_format(file.view());
+}
+
+bool convert_file(const std::string &in_path, const std::string &out_path, bool to_binary) {
+    Nonogram puzzle;
+    std::string error;
+    const bool read_ok = to_binary ? NonogramSource(in_path).read(puzzle, error)
+                                   : NonogramBinarySource(in_path).read(puzzle, error);
+    if (!read_ok) {
+        std::cerr << in_path << ": " << error << "\n";
+        return false;
+    }
+
+    std::ofstream out(out_path, std::ios::binary);
+    const bool write_ok = out && (to_binary ? BinaryFormat::write_binary_format(out, puzzle, error)
+                                            : TextFormat::write_text_format(out, puzzle, error));
+    if (!write_ok) {
+        std::cerr << "Failed to write " << out_path << "\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        std::cerr << "usage: convert [--to binary|text] IN OUT\n";
+        return 2;
+    }
+
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (!fs::is_directory(options.in, ec)) {
+        const bool to_binary = options.to == Target::Auto ? !is_binary_file(options.in) : options.to == Target::Binary;
+        return convert_file(options.in, options.out, to_binary) ? 0 : 1;
+    }
+
+    // In a directory each .txt file becomes binary and each .ngb file text, --to keeps only one direction
+    std::vector<fs::path> files;
+    for (const auto &entry : fs::directory_iterator(options.in, ec)) {
+        const auto ext = entry.path().extension();
+        if (entry.is_regular_file(ec) && ((ext == ".txt" && options.to != Target::Text) ||
+                                          (ext == ".ngb" && options.to != Target::Binary)))
+            files.push_back(entry.path());
+    }
+    if (ec) {
+        std::cerr << "Failed to list directory: " << options.in << "\n";
+        return 1;
+    }
+
+    fs::create_directories(options.out, ec);
+    if (ec) {
+        std::cerr << "Failed to create directory: " << options.out << "\n";
+        return 1;
+    }
+
+    int failed = 0;
+    for (const auto &file : files) {
+        const bool to_binary = file.extension() == ".txt";
+        fs::path out_path = fs::path(options.out) / file.filename();
+        out_path.replace_extension(to_binary ? ".ngb" : ".txt");
+        if (!convert_file(file.string(), out_path.string(), to_binary))
+            ++failed;
+    }
+    std::cout << files.size() - failed << " converted, " << failed << " failed\n";
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+// Writes generated puzzles in the puzzles/ text format, with the source grid on the right of each row.
+//
+// generate [--size N | --rows R --cols C] [--density D] [--seed S] [--pattern random|blocks|symmetric]
+//          [--count K] [--out FILE|DIR]
+//
+// Without --out the puzzle goes to stdout. With --count K the seeds S .. S+K-1 are written
+// to DIR as <rows>x<cols>-<pattern>-s<seed>.txt, or without --out one after another to stdout
+// (which `app --stream` reads as is).
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/Nonogram.h"
+#include "../include/NonogramGenerator.h"
+#include "../include/NonogramTextFormat.h"
+
+namespace {
+
+struct Options {
+    GeneratorOptions gen;
+    int count = 1;
+    std::string out; // stdout when empty
+};
+
+bool parse_args(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--size" && has_value) {
+            options.gen.rows = options.gen.cols = std::atoi(argv[++i]);
+        } else if (arg == "--rows" && has_value) {
+            options.gen.rows = std::atoi(argv[++i]);
+        } else if (arg == "--cols" && has_value) {
+            options.gen.cols = std::atoi(argv[++i]);
+        } else if (arg == "--density" && has_value) {
+            options.gen.density = std::atof(argv[++i]);
+        } else if (arg == "--seed" && has_value) {
+            options.gen.seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--count" && has_value) {
+            options.count = std::atoi(argv[++i]);
+        } else if (arg == "--out" && has_value) {
+            options.out = argv[++i];
+        } else if (arg == "--pattern" && has_value) {
+            const std::string pattern = argv[++i];
+            if (pattern == "random") {
+                options.gen.pattern = GeneratorPattern::Random;
+            } else if (pattern == "blocks") {
+                options.gen.pattern = GeneratorPattern::Blocks;
+            } else if (pattern == "symmetric") {
+                options.gen.pattern = GeneratorPattern::Symmetric;
+            } else {
+                std::cerr << "Unknown pattern: " << pattern << " (random, blocks or symmetric)\n";
+                return false;
+            }
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << "\n";
+            return false;
+        }
+    }
+
+    if (options.gen.rows <= 0 || options.gen.cols <= 0) {
+        std::cerr << "Rows and columns must be positive\n";
+        return false;
+    }
+    if (options.count < 1) {
+        std::cerr << "Count must be at least 1\n";
+        return false;
+    }
+    return true;
+}
+
+// The puzzle with its source grid as cells, so the writer draws it next to the row clues
+bool write_puzzle(std::ostream &out, const GeneratorOptions &gen, std::string &out_error) {
+    CellGrid solution;
+    Nonogram puzzle = generate_random_puzzle(gen, &solution);
+    puzzle.cells.swap(solution);
+    return TextFormat::write_text_format(out, puzzle, out_error);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_args(argc, argv, options)) {
+        std::cerr << "usage: generate [--size N | --rows R --cols C] [--density D] [--seed S]\n"
+                  << "                [--pattern random|blocks|symmetric] [--count K] [--out FILE|DIR]\n";
+        return 2;
+    }
+
+    std::string error;
+    const std::uint64_t first_seed = options.gen.seed;
+    if (options.out.empty()) {
+        for (int i = 0; i < options.count; ++i) {
+            GeneratorOptions gen = options.gen;
+            gen.seed = first_seed + static_cast<std::uint64_t>(i);
+            if (!write_puzzle(std::cout, gen, error)) {
+                std::cerr << error << "\n";
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    if (options.count == 1) {
+        std::ofstream out(options.out, std::ios::binary);
+        if (!out || !write_puzzle(out, options.gen, error)) {
+            std::cerr << "Failed to write " << options.out << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::create_directories(options.out, ec);
+    if (ec) {
+        std::cerr << "Failed to create directory: " << options.out << "\n";
+        return 1;
+    }
+
+    for (int i = 0; i < options.count; ++i) {
+        GeneratorOptions gen = options.gen;
+        gen.seed = first_seed + static_cast<std::uint64_t>(i);
+
+        std::ostringstream name;
+        name << gen.rows << "x" << gen.cols << "-" << generator_pattern_name(gen.pattern) << "-s" << gen.seed << ".txt";
+        const fs::path path = fs::path(options.out) / name.str();
+
+        std::ofstream out(path, std::ios::binary);
+        if (!out || !write_puzzle(out, gen, error)) {
+            std::cerr << "Failed to write " << path.string() << "\n";
+            return 1;
+        }
+        std::cout << path.string() << "\n";
+    }
+    return 0;
+}